@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 #define ALPHABET "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
@@ -9,6 +10,9 @@ struct Base64
     static std::string encode(const std::string str);
     static std::string decode(const std::string str);
 
+    static void encode(const char* data, const size_t size, std::string& result);
+    static void decode(const std::string& str, std::string& result);
+
 private:
     static char base64ToAscii(const char c);
 
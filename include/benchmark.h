@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "errors.h"
+#include "network.h"
+#include "transfer.h"
+
+#define BENCHMARK_SIZE 268435456
+#define BENCHMARK_MESSAGES 200000
+
+struct BenchmarkRunner
+{
+    BenchmarkRunner(ErrorHandler* errorHandler, NetworkManager* networkManager);
+
+    void run(const std::filesystem::path path, const unsigned int streams) const;
+
+private:
+    void runParser() const;
+
+    std::filesystem::path createFile() const;
+
+    ErrorHandler* errorHandler;
+    NetworkManager* networkManager;
+
+};
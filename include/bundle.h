@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "transfer.h"
+
+#define BATCH_THRESHOLD 4194304
+
+#define MANIFEST_MAX_SIZE 67108864
+#define MANIFEST_ENTRY_HEADER_SIZE 15
+
+enum EntryType
+{
+    DirectoryEntry = 0,
+    FileEntry = 1
+};
+
+struct ManifestEntry
+{
+    std::string name;
+
+    EntryType type = EntryType::FileEntry;
+
+    uint32_t mode = 0;
+    uint64_t size = 0;
+
+    bool isBatched() const;
+};
+
+struct Manifest
+{
+    bool add(const std::filesystem::path path);
+
+    std::string encode() const;
+    static bool decode(const std::string& data, Manifest& manifest);
+
+    bool hasSingleRoot() const;
+
+    std::string getName() const;
+
+    uint64_t getBatchSize() const;
+
+    const std::vector<ManifestEntry>& getEntries() const;
+
+    std::filesystem::path getSource(const size_t index) const;
+
+    static bool isSafe(const std::string& name);
+
+private:
+    bool addEntry(const std::filesystem::path source, const std::string name);
+
+    static std::string getRoot(const std::string& name);
+
+    std::vector<ManifestEntry> entries;
+    std::vector<std::filesystem::path> sources;
+
+};
+
+struct BatchReader
+{
+    BatchReader(const Manifest& manifest);
+
+    bool read(char* buffer, const uint64_t size);
+
+private:
+    const Manifest& manifest;
+
+    File file;
+
+    size_t entry = 0;
+
+    uint64_t offset = 0;
+
+};
+
+struct BundleSink : public ReceiveResult
+{
+    BundleSink(const std::filesystem::path directory, const uint64_t key, const Manifest& manifest);
+
+    bool isOpen() const;
+    bool isComplete() const;
+
+    uint64_t getKey() const;
+
+    const Manifest& getManifest() const;
+
+    bool restart();
+    bool write(const char* data, uint64_t size);
+    bool finish();
+    bool place(ReceiveResult* sink, const size_t index);
+
+    std::string getName() const override;
+
+    bool commit(const std::filesystem::path path) override;
+    void discard() override;
+
+private:
+    bool finishEntry();
+
+    const uint64_t key;
+
+    const Manifest manifest;
+
+    const std::filesystem::path stagingPath;
+
+    File file;
+
+    size_t entry = 0;
+
+    uint64_t offset = 0;
+    uint64_t written = 0;
+
+    size_t placed = 0;
+
+    bool open = false;
+
+};
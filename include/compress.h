@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#define CODEC_LZ4 "lz4"
+
+#define LZ4_MIN_MATCH 4
+#define LZ4_LAST_LITERALS 5
+#define LZ4_MATCH_LIMIT 12
+#define LZ4_MAX_OFFSET 65535
+#define LZ4_HASH_BITS 16
+
+#define COMPRESSION_SAMPLES 64
+#define COMPRESSION_SAMPLE_SIZE 128
+#define COMPRESSION_ENTROPY_LIMIT 7.5
+
+struct Compressor
+{
+    Compressor();
+
+    static uint64_t bound(const uint64_t size);
+
+    static double estimateEntropy(const char* data, const uint64_t size);
+
+    uint64_t compress(const char* data, const uint64_t size, char* output, const uint64_t capacity);
+    uint64_t compressChunk(const char* data, const uint64_t size, char* output, const uint64_t capacity);
+
+    static bool decompress(const char* data, const uint64_t size, char* output, const uint64_t expected);
+
+private:
+    std::vector<uint32_t> table;
+
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+
+#define RATE_INITIAL 4194304
+#define RATE_MINIMUM 131072
+#define RATE_STARTUP_GAIN 2.885
+#define RATE_PROBE_GAIN 1.25
+#define RATE_DRAIN_GAIN 0.75
+#define RATE_PROBE_CYCLE 8
+#define RATE_STARTUP_ROUNDS 3
+#define RATE_FILTER_ROUNDS 10
+#define RATE_MIN_ROUND 10
+#define RATE_LOSS_THRESHOLD 0.2
+#define RATE_LOSS_BACKOFF 0.8
+#define RATE_MIN_WINDOW 262144
+#define RATE_INITIAL_TIMEOUT 1000
+#define RATE_MIN_TIMEOUT 200
+#define RATE_MAX_TIMEOUT 8000
+
+enum RatePhase
+{
+    RateStartup,
+    RateProbe
+};
+
+struct RateController
+{
+    RateController();
+
+    void acknowledged(const uint64_t bytes, const double roundTrip);
+    void lost(const uint64_t bytes);
+    void timedOut();
+    void blocked();
+
+    double getRate() const;
+    uint64_t getWindow() const;
+    std::chrono::microseconds getTimeout() const;
+
+private:
+    void finishRound(const std::chrono::time_point<std::chrono::steady_clock> now);
+
+    double getGain() const;
+
+    RatePhase phase = RatePhase::RateStartup;
+
+    double bandwidth = RATE_INITIAL;
+    double fullBandwidth = 0;
+
+    std::deque<double> samples;
+
+    double smoothedTrip = 0;
+    double tripVariance = 0;
+    double minTrip = 0;
+
+    unsigned int stalledRounds = 0;
+    unsigned int cycle = 0;
+    unsigned int backoff = 0;
+
+    uint64_t roundDelivered = 0;
+    uint64_t roundLost = 0;
+
+    bool roundBlocked = false;
+
+    std::chrono::time_point<std::chrono::steady_clock> roundStart;
+
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+#define MAX_STREAMS 16
+
+#define TRANSFER_CONCURRENCY 8
+#define MAX_CONCURRENCY 64
+
+#define DATAGRAM_MAX_LATENCY 10000
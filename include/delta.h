@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "hash.h"
+#include "transfer.h"
+
+#define DELTA_MIN_BLOCK 2048
+#define DELTA_MAX_BLOCK 131072
+#define DELTA_MAX_BLOCKS 4194304
+
+#define DELTA_STRONG_SIZE 16
+#define DELTA_SIGNATURE_SIZE 20
+
+struct RollingChecksum
+{
+    void reset(const char* data, const size_t size);
+    void roll(const char out, const char in);
+
+    uint32_t value() const;
+
+private:
+    uint32_t a = 0;
+    uint32_t b = 0;
+
+    uint32_t size = 0;
+
+};
+
+struct BlockSignature
+{
+    uint32_t weak = 0;
+
+    char strong[DELTA_STRONG_SIZE];
+};
+
+struct Signature
+{
+    static uint32_t chooseBlockSize(const uint64_t size);
+
+    bool compute(const File& file, const uint64_t size);
+
+    std::string encode() const;
+    bool decode(const std::string& data, const uint32_t blockSize);
+
+    uint32_t getBlockSize() const;
+
+    const std::vector<BlockSignature>& getBlocks() const;
+
+private:
+    uint32_t blockSize = 0;
+
+    std::vector<BlockSignature> blocks;
+
+};
+
+struct DeltaEncoder
+{
+    DeltaEncoder(const Signature& signature);
+
+    bool encode(const File& file, const uint64_t size,
+        const std::function<bool(const uint64_t, const char*, const uint64_t)> emitLiteral,
+        const std::function<bool(const uint64_t, const uint64_t, const uint64_t)> emitCopy) const;
+
+private:
+    int64_t find(const uint32_t weak, const char* data, const uint64_t expected) const;
+
+    static uint32_t filterIndex(const uint32_t weak);
+
+    const Signature& signature;
+
+    std::unordered_map<uint32_t, std::vector<uint32_t>> index;
+
+    std::vector<bool> filter;
+
+};
@@ -7,6 +7,7 @@ struct FileManager
 {
     virtual std::filesystem::path getSavePath(const std::string name) const = 0;
     virtual std::filesystem::path getResourcePath(const std::string name) const = 0;
+    virtual std::filesystem::path getReceivePath() const = 0;
 };
 
 #ifdef _WIN32
@@ -19,6 +20,7 @@ struct WinFileManager : public FileManager
 {
     std::filesystem::path getSavePath(const std::string name) const override;
     std::filesystem::path getResourcePath(const std::string name) const override;
+    std::filesystem::path getReceivePath() const override;
 };
 
 #elif __APPLE__
@@ -27,17 +29,20 @@ struct MacFileManager : public FileManager
 {
     std::filesystem::path getSavePath(const std::string name) const override;
     std::filesystem::path getResourcePath(const std::string name) const override;
+    std::filesystem::path getReceivePath() const override;
 };
 
 #else
 
 #include <limits.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 struct LinuxFileManager : public FileManager
 {
     std::filesystem::path getSavePath(const std::string name) const override;
     std::filesystem::path getResourcePath(const std::string name) const override;
+    std::filesystem::path getReceivePath() const override;
 };
 
 #endif
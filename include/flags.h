@@ -3,13 +3,16 @@
 #include <filesystem>
 #include <string>
 #include <string.h>
+#include <vector>
 
+#include "defaults.h"
 #include "errors.h"
 
 enum LaunchType
 {
     Service,
     Receive,
+    Benchmark,
     General
 };
 
@@ -19,6 +22,22 @@ struct Flags
 
     LaunchType type = LaunchType::General;
 
-    std::string path;
+    std::vector<std::string> paths;
+
     std::string ip;
+
+    unsigned int streams = 0;
+    unsigned int concurrency = TRANSFER_CONCURRENCY;
+
+    uint64_t bandwidth = 0;
+    uint64_t peerBandwidth = 0;
+    uint64_t transferBandwidth = 0;
+
+    unsigned int loss = 0;
+    unsigned int latency = 0;
+
+    bool dedup = false;
+    bool compress = false;
+    bool ioUring = false;
+    bool udp = false;
 };
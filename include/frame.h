@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#define FRAME_MAGIC "SQRL"
+#define FRAME_VERSION 1
+#define FRAME_HEADER_SIZE 20
+#define FRAME_MESSAGE_LIMIT 65536
+
+#define FRAME_FLAG_COMPRESSED 0x0001
+
+#define STREAM_MAGIC "SQMX"
+#define STREAM_VERSION 1
+#define STREAM_PREFACE_SIZE 5
+#define STREAM_HEADER_SIZE 9
+#define STREAM_FRAME_SIZE 65536
+
+#define DATAGRAM_VERSION 1
+#define DATAGRAM_SIZE 1472
+#define DATAGRAM_HEADER_SIZE 22
+#define DATAGRAM_PAYLOAD (DATAGRAM_SIZE - DATAGRAM_HEADER_SIZE)
+#define DATAGRAM_ACK_SIZE 6
+#define DATAGRAM_SACK_SIZE 1024
+
+enum FrameType
+{
+    Control = 0,
+    Data = 1
+};
+
+enum FrameDecoderState
+{
+    DecodingHeader = 0,
+    DecodingBody = 1
+};
+
+enum StreamFrameType
+{
+    StreamData = 0,
+    StreamWindow = 1,
+    StreamClose = 2
+};
+
+enum DatagramType
+{
+    DatagramData = 0,
+    DatagramAck = 1,
+    DatagramClose = 2
+};
+
+struct FrameHeader
+{
+    FrameHeader();
+    FrameHeader(const FrameType type, const uint16_t flags, const uint32_t messageLength, const uint64_t payloadLength);
+
+    void encode(char* buffer) const;
+
+    static bool decode(const char* buffer, FrameHeader& header);
+
+    uint8_t version = FRAME_VERSION;
+
+    FrameType type = FrameType::Control;
+
+    uint16_t flags = 0;
+    uint32_t messageLength = 0;
+    uint64_t payloadLength = 0;
+};
+
+struct FrameDecoder
+{
+    FrameDecoder();
+
+    void setLimit(const FrameType type, const uint32_t messageLimit, const uint64_t payloadLimit);
+
+    bool feed(const char* data, const uint64_t size);
+    bool next(FrameHeader& frame, std::string_view& message, std::string_view& payload);
+
+    bool isValid() const;
+
+private:
+    bool advance();
+
+    std::string buffer;
+
+    size_t position = 0;
+
+    FrameDecoderState state = FrameDecoderState::DecodingHeader;
+
+    FrameHeader header;
+
+    uint32_t messageLimits[2] = { FRAME_MESSAGE_LIMIT, FRAME_MESSAGE_LIMIT };
+    uint64_t payloadLimits[2] = { 0, 0 };
+
+    bool valid = true;
+
+};
+
+struct StreamHeader
+{
+    StreamHeader();
+    StreamHeader(const StreamFrameType type, const uint32_t stream, const uint32_t length);
+
+    void encode(char* buffer) const;
+
+    static bool decode(const char* buffer, StreamHeader& header);
+
+    static void encodePreface(char* buffer);
+    static bool decodePreface(const char* buffer);
+
+    StreamFrameType type = StreamFrameType::StreamData;
+
+    uint32_t stream = 0;
+    uint32_t length = 0;
+};
+
+struct DatagramHeader
+{
+    DatagramHeader();
+    DatagramHeader(const DatagramType type, const uint32_t token, const uint64_t sequence, const uint64_t timestamp);
+
+    void encode(char* buffer) const;
+
+    static bool decode(const char* buffer, const uint64_t size, DatagramHeader& header);
+
+    DatagramType type = DatagramType::DatagramData;
+
+    uint32_t token = 0;
+
+    uint64_t sequence = 0;
+    uint64_t timestamp = 0;
+};
+
+struct SelectiveAck
+{
+    uint64_t encode(char* buffer, const uint64_t base) const;
+
+    static bool decode(const char* buffer, const uint64_t size, const uint64_t base, SelectiveAck& ack);
+
+    uint32_t window = 0;
+
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+};
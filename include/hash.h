@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define SHA256_SIZE 32
+
+#define XXH64_PRIME_1 0x9e3779b185ebca87ull
+#define XXH64_PRIME_2 0xc2b2ae3d27d4eb4full
+#define XXH64_PRIME_3 0x165667b19e3779f9ull
+#define XXH64_PRIME_4 0x85ebca77c2b2ae63ull
+#define XXH64_PRIME_5 0x27d4eb2f165667c5ull
+
+struct Sha256
+{
+    Sha256();
+
+    static std::string digest(const char* data, const size_t size);
+
+    void update(const char* data, size_t size);
+
+    std::string finish();
+
+private:
+    void transform(const unsigned char* block);
+
+    uint32_t state[8];
+
+    unsigned char buffer[64];
+
+    size_t buffered = 0;
+
+    uint64_t length = 0;
+
+};
+
+struct XXHash64
+{
+    static uint64_t digest(const char* data, const size_t size, const uint64_t seed);
+};
+
+struct HashTree
+{
+    static uint64_t root(std::vector<uint64_t> leaves);
+};
@@ -1,22 +1,51 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <new>
 #include <optional>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
+#define JSON_MAX_DEPTH 16
+#define JSON_ARENA_BLOCK 1024
+
+struct JSONView
+{
+    JSONView();
+
+    static bool deserialize(const std::string_view text, JSONView& view);
+
+    JSONView getProperty(const std::string_view name) const;
+
+    bool next(size_t& position, std::string_view& name, JSONView& value) const;
+
+    bool isObject() const;
+
+    std::optional<std::string_view> asString() const;
+    std::optional<uint64_t> asInteger() const;
+
+private:
+    JSONView(const std::string_view text);
+
+    std::string_view text;
+
+};
+
 struct JSONObject
 {
     JSONObject(const std::unordered_map<std::string, const JSONObject*>& properties);
+    virtual ~JSONObject();
 
-    static JSONObject* deserialize(std::stringstream& stream);
+    virtual void serialize(std::string& buffer) const;
 
-    virtual void serialize(std::stringstream& stream) const;
-
-    const JSONObject* getProperty(const std::string name) const;
+    virtual const JSONObject* getProperty(const std::string name) const;
 
     virtual std::optional<std::string> asString() const;
+    virtual std::optional<uint64_t> asInteger() const;
 
 private:
     const std::unordered_map<std::string, const JSONObject*> properties;
@@ -27,24 +56,91 @@ struct JSONString : public JSONObject
 {
     JSONString(const std::string str);
 
-    static JSONString* deserialize(std::stringstream& stream);
-
-    void serialize(std::stringstream& stream) const override;
+    void serialize(std::string& buffer) const override;
 
     std::optional<std::string> asString() const override;
+    std::optional<uint64_t> asInteger() const override;
 
 private:
     const std::string str;
 
 };
 
+struct JSONArenaProperty
+{
+    std::string_view name;
+
+    const JSONObject* value;
+};
+
+struct JSONArenaObject : public JSONObject
+{
+    JSONArenaObject(const JSONArenaProperty* entries, const size_t count);
+    ~JSONArenaObject();
+
+    void serialize(std::string& buffer) const override;
+
+    const JSONObject* getProperty(const std::string name) const override;
+
+private:
+    const JSONArenaProperty* entries;
+
+    const size_t count;
+
+};
+
+struct JSONArenaString : public JSONObject
+{
+    JSONArenaString(const std::string_view str);
+
+    void serialize(std::string& buffer) const override;
+
+    std::optional<std::string> asString() const override;
+    std::optional<uint64_t> asInteger() const override;
+
+private:
+    const std::string_view str;
+
+};
+
+struct JSONArena
+{
+    JSONArena();
+    ~JSONArena();
+
+    const JSONObject* build(const JSONView& view);
+
+private:
+    void* allocate(const size_t size);
+
+    std::string_view copy(const std::string_view text);
+
+    char* block = nullptr;
+
+    size_t used = 0;
+    size_t capacity = 0;
+
+};
+
 struct Message
 {
     Message(const JSONObject* data);
+    Message(const JSONObject* data, const uint16_t flags, const uint64_t payloadSize);
+    Message(const JSONView& view, const uint16_t flags, const uint64_t payloadSize);
+    ~Message();
 
-    static Message* deserialize(std::stringstream& stream);
+    static Message* deserialize(const std::string_view text);
 
-    void serialize(std::stringstream& stream) const;
+    void serialize(std::string& buffer) const;
 
     const JSONObject* data;
+
+    const uint16_t flags = 0;
+    const uint64_t payloadSize = 0;
+
+private:
+    JSONArena arena;
+
+    const bool parsed = false;
+
 };
@@ -1,30 +1,89 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <functional>
-#include <sstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
 #include <string>
 #include <thread>
-
-#include "base64.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "bundle.h"
+#include "compress.h"
+#include "congestion.h"
+#include "defaults.h"
+#include "delta.h"
 #include "errors.h"
+#include "frame.h"
 #include "json.h"
+#include "pipeline.h"
+#include "protocol.h"
+#include "reactor.h"
+#include "scheduler.h"
+#include "store.h"
+#include "transfer.h"
+#include "tuning.h"
 
 #define BROADCAST_PORT 4242
 #define TRANSFER_PORT 4243
 #define SERVICE_PORT 4244
+#define BENCHMARK_PORT 4245
+
+#define LISTEN_BACKLOG 16
+
+#define CONNECT_ATTEMPTS 50
+#define CONNECT_INTERVAL 100
+
+#define RESUME_ATTEMPTS 5
+#define RESUME_INTERVAL 1000
+
+#define ACCEPT_TIMEOUT 10000
+
+#define MUX_IDLE_TIMEOUT 60000
+#define MUX_SWEEP_INTERVAL 5000
+
+#define BROADCAST_INTERVAL 1000
+
+#define STREAM_WINDOW 4194304
+
+#define DATAGRAM_WINDOW (DATAGRAM_SACK_SIZE * 8)
+#define DATAGRAM_TICK 5
+#define DATAGRAM_ACK_FREQUENCY 4
+#define DATAGRAM_REORDER 3
+#define DATAGRAM_PACING_SLACK 500
+#define DATAGRAM_TIMEOUT 10000
 
 #define BUFFER_SIZE 512
+#define MESSAGE_BUFFER_SIZE 4096
+#define FILE_BUFFER_SIZE 65536
+#define SERVICE_MESSAGE_SIZE 65536
 
 struct UDPSocket
 {
+    virtual ~UDPSocket() = default;
+
     virtual bool create(const std::string address) = 0;
     virtual bool socketBind(const std::string address, const unsigned int port) const = 0;
     virtual bool socketSend(const Message* message, const std::string address, const unsigned int port) const = 0;
+    virtual bool sendDatagram(const char* data, const uint64_t size, const std::string address, const unsigned int port) const = 0;
 
     virtual Message* receive() const = 0;
+    virtual int64_t receiveDatagram(char* buffer, const uint64_t size, std::string& address, unsigned int& port) const = 0;
+
+    virtual SocketHandle getHandle() const = 0;
+    virtual unsigned int getPort() const = 0;
+    virtual bool setBlocking(const bool blocking) const = 0;
 
     virtual bool destroy() = 0;
     virtual bool isAlive() const = 0;
@@ -32,19 +91,421 @@ struct UDPSocket
 
 struct TCPSocket
 {
+    virtual ~TCPSocket() = default;
+
     virtual bool create() = 0;
     virtual bool socketBind(const std::string address, const unsigned int port) const = 0;
     virtual bool socketConnect(const std::string address, const unsigned int port) const = 0;
     virtual bool socketListen() const = 0;
     virtual bool socketAccept() = 0;
+    virtual TCPSocket* acceptConnection() const = 0;
     virtual bool socketSend(const Message* message) const = 0;
+    virtual bool sendPayload(const char* data, const uint64_t size) const = 0;
+    virtual bool sendVectored(const char* header, const uint64_t headerSize, const char* data, const uint64_t size) const = 0;
+    virtual bool sendFileRange(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const = 0;
 
-    virtual Message* receive() const = 0;
+    bool sendMessage(const Message* message, const char* payload, const uint64_t size) const;
+    bool sendMessage(const ProtocolMessage& message, const uint16_t flags, const char* payload, const uint64_t size) const;
+
+    Message* receive() const;
+    bool receiveMessage(std::string& buffer, FrameHeader& header, JSONView& message) const;
+
+    virtual bool receivePayload(char* buffer, const uint64_t size) const = 0;
+    virtual bool receiveToFile(const File& file, const uint64_t offset, const uint64_t size) const = 0;
+    virtual bool receiveAvailable(std::string& buffer) const = 0;
+
+    virtual SocketHandle getHandle() const = 0;
+    virtual bool setBlocking(const bool blocking) const = 0;
+    virtual bool setProfile(const SocketProfile profile) const = 0;
+    virtual bool setBuffers(const uint64_t sendBuffer, const uint64_t receiveBuffer) const = 0;
+    virtual bool getTuning(SocketTuning& tuning) const = 0;
 
     virtual bool destroy() = 0;
     virtual bool isAlive() const = 0;
 };
 
+struct MuxChannel
+{
+    std::string buffer;
+
+    size_t position = 0;
+
+    uint64_t credit = STREAM_WINDOW;
+    uint64_t consumed = 0;
+
+    bool ended = false;
+};
+
+struct MuxConnection : public std::enable_shared_from_this<MuxConnection>
+{
+    MuxConnection(TCPSocket* socket, Reactor* reactor, const bool initiator, const std::function<void(TCPSocket*)> handleStream);
+    ~MuxConnection();
+
+    bool start();
+    void shutdown();
+
+    TCPSocket* open(TransferJob* job);
+
+    bool write(const uint32_t stream, const char* data, const uint64_t length);
+    bool writeFile(const uint32_t stream, const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t length);
+    bool read(const uint32_t stream, char* buffer, const uint64_t length);
+    bool readAvailable(const uint32_t stream, std::string& buffer);
+    void close(const uint32_t stream);
+
+    size_t getStreamCount();
+
+    SocketTuning getTuning();
+
+    bool isIdle(const unsigned int timeout);
+    bool isAlive() const;
+
+private:
+    void receive();
+    void tune();
+    bool handleFrame(const StreamHeader& header, const char* data);
+    uint64_t reserve(const uint32_t stream, const uint64_t length);
+    void encodeHeader(const StreamHeader& header);
+    bool sendFrame(const StreamHeader& header, const char* data);
+    bool sendFileFrame(const StreamHeader& header, const char* prefix, const uint64_t prefixSize, const File& file, const uint64_t offset, const uint64_t length);
+
+    TCPSocket* socket;
+    Reactor* reactor;
+
+    const bool initiator;
+
+    const std::function<void(TCPSocket*)> handleStream;
+
+    std::unordered_map<uint32_t, MuxChannel> channels;
+
+    std::string input;
+    std::string output;
+
+    uint32_t nextStream = 0;
+    uint32_t lastPeerStream = 0;
+
+    bool prefaced = false;
+    bool greeted = false;
+
+    SocketTuning tuning;
+
+    std::atomic<uint64_t> sentBytes = 0;
+    std::atomic<uint64_t> receivedBytes = 0;
+
+    std::chrono::time_point<std::chrono::steady_clock> measuredSince;
+    std::chrono::time_point<std::chrono::steady_clock> idleSince;
+
+    unsigned int tuneRounds = 0;
+
+    uint64_t tuneTimer = 0;
+
+    std::atomic<bool> failed = false;
+
+    std::mutex lock;
+    std::mutex writeLock;
+    std::mutex tuneLock;
+
+    std::condition_variable signal;
+
+};
+
+struct MuxStream : public TCPSocket
+{
+    MuxStream(const std::shared_ptr<MuxConnection> connection, const uint32_t stream, TransferJob* job);
+    ~MuxStream();
+
+    bool create() override;
+    bool socketBind(const std::string address, const unsigned int port) const override;
+    bool socketConnect(const std::string address, const unsigned int port) const override;
+    bool socketListen() const override;
+    bool socketAccept() override;
+    TCPSocket* acceptConnection() const override;
+    bool socketSend(const Message* message) const override;
+    bool sendPayload(const char* data, const uint64_t size) const override;
+    bool sendVectored(const char* header, const uint64_t headerSize, const char* data, const uint64_t size) const override;
+    bool sendFileRange(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const override;
+
+    bool receivePayload(char* buffer, const uint64_t size) const override;
+    bool receiveToFile(const File& file, const uint64_t offset, const uint64_t size) const override;
+    bool receiveAvailable(std::string& buffer) const override;
+
+    SocketHandle getHandle() const override;
+    bool setBlocking(const bool blocking) const override;
+    bool setProfile(const SocketProfile profile) const override;
+    bool setBuffers(const uint64_t sendBuffer, const uint64_t receiveBuffer) const override;
+    bool getTuning(SocketTuning& tuning) const override;
+
+    bool destroy() override;
+    bool isAlive() const override;
+
+private:
+    std::shared_ptr<MuxConnection> connection;
+
+    const uint32_t stream;
+
+    TransferJob* job;
+
+    bool open = true;
+
+};
+
+struct MuxPending
+{
+    TCPSocket* stream;
+
+    std::chrono::time_point<std::chrono::steady_clock> queued;
+};
+
+struct MuxBacklog
+{
+    void track(const std::shared_ptr<MuxConnection> connection);
+    void push(TCPSocket* stream);
+
+    TCPSocket* pop(const unsigned int timeout);
+
+    void sweep(const unsigned int idleTimeout);
+    void close();
+
+private:
+    std::vector<std::shared_ptr<MuxConnection>> connections;
+
+    std::queue<MuxPending> streams;
+
+    std::vector<TCPSocket*> expired;
+
+    bool closed = false;
+
+    std::mutex lock;
+
+    std::condition_variable signal;
+
+};
+
+struct MuxListener : public TCPSocket
+{
+    MuxListener(TCPSocket* socket, Reactor* reactor);
+    ~MuxListener();
+
+    bool create() override;
+    bool socketBind(const std::string address, const unsigned int port) const override;
+    bool socketConnect(const std::string address, const unsigned int port) const override;
+    bool socketListen() const override;
+    bool socketAccept() override;
+    TCPSocket* acceptConnection() const override;
+    bool socketSend(const Message* message) const override;
+    bool sendPayload(const char* data, const uint64_t size) const override;
+    bool sendVectored(const char* header, const uint64_t headerSize, const char* data, const uint64_t size) const override;
+    bool sendFileRange(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const override;
+
+    bool receivePayload(char* buffer, const uint64_t size) const override;
+    bool receiveToFile(const File& file, const uint64_t offset, const uint64_t size) const override;
+    bool receiveAvailable(std::string& buffer) const override;
+
+    SocketHandle getHandle() const override;
+    bool setBlocking(const bool blocking) const override;
+    bool setProfile(const SocketProfile profile) const override;
+    bool setBuffers(const uint64_t sendBuffer, const uint64_t receiveBuffer) const override;
+    bool getTuning(SocketTuning& tuning) const override;
+
+    bool destroy() override;
+    bool isAlive() const override;
+
+private:
+    void acceptConnections() const;
+
+    TCPSocket* socket;
+    Reactor* reactor;
+
+    std::shared_ptr<MuxBacklog> backlog;
+
+    mutable uint64_t sweepTimer = 0;
+
+};
+
+struct DatagramPacket
+{
+    std::string data;
+
+    uint64_t order = 0;
+
+    std::chrono::time_point<std::chrono::steady_clock> sent;
+
+    bool lost = false;
+};
+
+struct DatagramConnection : public std::enable_shared_from_this<DatagramConnection>
+{
+    DatagramConnection(UDPSocket* socket, Reactor* reactor, const uint32_t token, const std::string address, const unsigned int port);
+    ~DatagramConnection();
+
+    bool start();
+    void shutdown();
+
+    bool write(const char* data, const uint64_t length);
+    bool read(char* buffer, const uint64_t length);
+    bool readAvailable(std::string& buffer);
+    bool close();
+
+    bool isAlive() const;
+
+private:
+    bool transmit(const char* data, const uint64_t length);
+
+    void receive();
+    void tick();
+
+    void handleData(const DatagramHeader& header, const char* data, const uint64_t size);
+    void handleAck(const DatagramHeader& header, const SelectiveAck& ack);
+    void handleClose();
+
+    void sendAck();
+    void sendClose();
+
+    uint32_t getWindow() const;
+
+    UDPSocket* socket;
+    Reactor* reactor;
+
+    const uint32_t token;
+
+    const std::string address;
+
+    unsigned int port;
+
+    const bool passive;
+
+    RateController controller;
+
+    std::map<uint64_t, DatagramPacket> packets;
+    std::map<uint64_t, uint64_t> transmissions;
+    std::deque<uint64_t> lost;
+
+    uint64_t nextSequence = 0;
+    uint64_t nextOrder = 0;
+    uint64_t highestOrder = 0;
+    uint64_t inflight = 0;
+    uint64_t peerAcknowledged = 0;
+    uint64_t peerWindow = DATAGRAM_WINDOW;
+
+    std::chrono::time_point<std::chrono::steady_clock> nextSend;
+
+    std::map<uint64_t, std::string> received;
+    std::map<uint64_t, uint64_t> runs;
+
+    std::string input;
+
+    size_t position = 0;
+
+    uint64_t expected = 0;
+    uint64_t echo = 0;
+
+    unsigned int pendingAcks = 0;
+
+    uint32_t advertised = DATAGRAM_WINDOW;
+
+    std::chrono::time_point<std::chrono::steady_clock> lastHeard;
+
+    uint64_t timer = 0;
+
+    bool ended = false;
+
+    std::atomic<bool> failed = false;
+
+    std::mutex lock;
+
+    std::condition_variable signal;
+
+};
+
+struct DatagramStream : public TCPSocket
+{
+    DatagramStream(const std::shared_ptr<DatagramConnection> connection, TransferJob* job);
+    ~DatagramStream();
+
+    bool create() override;
+    bool socketBind(const std::string address, const unsigned int port) const override;
+    bool socketConnect(const std::string address, const unsigned int port) const override;
+    bool socketListen() const override;
+    bool socketAccept() override;
+    TCPSocket* acceptConnection() const override;
+    bool socketSend(const Message* message) const override;
+    bool sendPayload(const char* data, const uint64_t size) const override;
+    bool sendVectored(const char* header, const uint64_t headerSize, const char* data, const uint64_t size) const override;
+    bool sendFileRange(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const override;
+
+    bool receivePayload(char* buffer, const uint64_t size) const override;
+    bool receiveToFile(const File& file, const uint64_t offset, const uint64_t size) const override;
+    bool receiveAvailable(std::string& buffer) const override;
+
+    SocketHandle getHandle() const override;
+    bool setBlocking(const bool blocking) const override;
+    bool setProfile(const SocketProfile profile) const override;
+    bool setBuffers(const uint64_t sendBuffer, const uint64_t receiveBuffer) const override;
+    bool getTuning(SocketTuning& tuning) const override;
+
+    bool destroy() override;
+    bool isAlive() const override;
+
+private:
+    std::shared_ptr<DatagramConnection> connection;
+
+    TransferJob* job;
+
+    bool open = true;
+
+};
+
+struct DelayedDatagram
+{
+    std::chrono::time_point<std::chrono::steady_clock> due;
+
+    std::string data;
+    std::string address;
+
+    unsigned int port = 0;
+};
+
+struct ImpairedUDPSocket : public UDPSocket
+{
+    ImpairedUDPSocket(UDPSocket* socket, const unsigned int loss, const unsigned int latency);
+    ~ImpairedUDPSocket();
+
+    bool create(const std::string address) override;
+    bool socketBind(const std::string address, const unsigned int port) const override;
+    bool socketSend(const Message* message, const std::string address, const unsigned int port) const override;
+    bool sendDatagram(const char* data, const uint64_t size, const std::string address, const unsigned int port) const override;
+
+    Message* receive() const override;
+    int64_t receiveDatagram(char* buffer, const uint64_t size, std::string& address, unsigned int& port) const override;
+
+    SocketHandle getHandle() const override;
+    unsigned int getPort() const override;
+    bool setBlocking(const bool blocking) const override;
+
+    bool destroy() override;
+    bool isAlive() const override;
+
+private:
+    void deliver();
+
+    UDPSocket* socket;
+
+    const unsigned int loss;
+    const unsigned int latency;
+
+    mutable std::mt19937 generator;
+
+    mutable std::deque<DelayedDatagram> delayed;
+
+    bool stopping = false;
+
+    mutable std::mutex lock;
+
+    mutable std::condition_variable signal;
+
+    std::thread thread;
+
+};
+
 struct NetworkManager
 {
     NetworkManager(ErrorHandler* errorHandler, const std::string name, const std::string address);
@@ -53,15 +514,43 @@ struct NetworkManager
 
     virtual std::string convertAddress(const unsigned int address) const = 0;
 
-    void beginService(const std::function<void(const std::string)> handleConnect);
+    void beginService(const std::filesystem::path directory, const std::function<void(const std::string, const std::filesystem::path)> handleReceive);
     void beginClient(const std::function<void(const std::string, const std::string)> handleResponse);
     void beginConnect(const std::string ip);
-    void beginTransfer(const std::filesystem::path path, const std::string ip);
-    void beginReceive(const std::string ip, const std::function<void(const std::string, const std::string&)> handleReceive);
+    void beginTransfer(const std::vector<std::filesystem::path> paths, const std::string ip);
+    void beginFanOut(const std::vector<std::filesystem::path> paths, const std::vector<std::string> ips);
+    void beginReceive(const std::string ip, const std::filesystem::path directory, const std::function<void(const std::string, ReceiveResult*)> handleReceive);
+
+    bool sendFile(const std::filesystem::path path, const std::string ip, const unsigned int port, const unsigned int streams, TransferJob* job);
+    bool sendFiles(const std::vector<std::filesystem::path> paths, const std::string ip, const unsigned int port, const unsigned int streams, TransferJob* job);
+
+    ReceiveResult* receiveFile(const std::string ip, const unsigned int port, const std::filesystem::path directory);
+
+    void setStreamCount(const unsigned int streams);
+    void setDeduplicate(const bool deduplicate);
+    void setCompression(const bool compression);
+    void setIoUring(const bool ioUring);
+    void setConcurrency(const unsigned int concurrency);
+    void setBandwidth(const uint64_t bandwidth);
+    void setPeerBandwidth(const uint64_t bandwidth);
+    void setPeerBandwidth(const std::string ip, const uint64_t bandwidth);
+    void setTransferBandwidth(const uint64_t bandwidth);
+    void setTransferBandwidth(const uint64_t id, const uint64_t bandwidth);
+    void setDatagram(const bool datagram);
+    void setImpairment(const unsigned int loss, const unsigned int latency);
+
+    std::vector<TransferStatus> getTransfers();
+
+    std::vector<StageCounters> getPipelineCounters();
+    std::vector<SocketTuning> getConnectionTunings();
+
+    std::string getLocalAddress() const;
 
 protected:
     ErrorHandler* errorHandler;
 
+    bool ioUring = false;
+
     virtual UDPSocket* newUDPSocket() const = 0;
     virtual TCPSocket* newTCPSocket() const = 0;
 
@@ -69,18 +558,87 @@ protected:
     virtual std::string getAddress() const = 0;
 
 private:
+    void receiveDiscovery(const std::function<void(const std::string)> handleConnect);
+    void receiveQueued(const std::filesystem::path directory, const std::function<void(const std::string, const std::filesystem::path)> handleReceive);
+    void acceptClients();
+    void receiveClient(TCPSocket* client, FrameDecoder* decoder);
+
+    TCPSocket* connectTransfer(const std::string ip, const unsigned int port, TransferJob* job);
+    TCPSocket* listenTransfer(const unsigned int port);
+
+    TCPSocket* connectDatagram(const std::string ip, const unsigned int port, const uint32_t token, TransferJob* job);
+    TCPSocket* listenDatagram(const std::string ip, const uint32_t token, unsigned int& port);
+
+    UDPSocket* newDatagramSocket() const;
+
+    bool sendTransfer(TransferJob* job);
+    bool transferFile(const std::filesystem::path path, const std::string fileName, const std::string ip, const unsigned int port, const unsigned int streams, TransferJob* job);
+
+    ReceiveResult* receiveTransfer(const TCPSocket* listener, const std::string ip, const std::filesystem::path directory);
+    bool receiveSessions(const TCPSocket* listener, const std::string ip, const std::filesystem::path directory, ReceiveSink*& sink, BundleSink*& bundle);
+
+    bool sendSession(ChunkReader& reader, const std::string fileName, const std::string ip, const unsigned int port, const unsigned int streams, const uint64_t key, TransferJob* job, bool& incremental);
+    bool receiveSession(const TCPSocket* listener, TCPSocket* control, const ProtocolMessage& header, const std::string ip, const std::filesystem::path directory, ReceiveSink*& sink);
+
+    bool sendBundle(const Manifest& manifest, const std::string ip, const unsigned int port, const uint64_t key, TransferJob* job);
+    bool receiveBundle(const TCPSocket* control, const ProtocolMessage& header, const uint64_t payloadSize, const std::string ip, const std::filesystem::path directory, BundleSink*& bundle);
+
+    bool sendHashes(const TCPSocket* control, ChunkHasher& hasher);
+    bool verifyHashes(const TCPSocket* control, ChunkHasher& hasher, ReceiveSink*& sink);
+
+    bool sendDelta(const TCPSocket* control, const ChunkReader& reader, const uint64_t blockSize, const uint64_t signatureSize);
+    bool receiveDelta(const TCPSocket* control, const std::filesystem::path path, ReceiveSink* sink, ChunkHasher& hasher);
+
+    bool sendDeduplicated(const TCPSocket* control, const ChunkReader& reader);
+    bool receiveDeduplicated(const TCPSocket* control, const std::filesystem::path directory, ReceiveSink* sink, ChunkHasher& hasher);
+
     const std::string name;
     const std::string address;
 
     UDPSocket* broadcastSocket = nullptr;
-    TCPSocket* transferSocket = nullptr;
     TCPSocket* serviceSocket = nullptr;
 
-    std::thread broadcastThread;
-    std::thread responseThread;
-    std::thread listenThread;
+    unsigned int streamCount = 0;
+
+    bool deduplicate = false;
+    bool compression = false;
+    bool datagram = false;
+
+    unsigned int loss = 0;
+    unsigned int latency = 0;
+
+    std::unordered_map<std::string, StreamTuner> tuners;
+
+    std::vector<StageCounters> pipelineCounters;
+    std::vector<SocketTuning> connectionTunings;
+
+    std::mutex tunerLock;
+    std::mutex counterLock;
+
+    Reactor reactor;
+
+    uint64_t broadcastTimer = 0;
+
+    std::vector<TCPSocket*> serviceClients;
+
     std::thread transferThread;
-    std::thread serviceThread;
+
+    TCPSocket* transferListener = nullptr;
+
+    std::queue<std::string> receives;
+
+    std::mutex receiveLock;
+
+    std::condition_variable receiveSignal;
+
+    std::thread receiveThread;
+
+    std::unordered_map<std::string, std::vector<std::shared_ptr<MuxConnection>>> connections;
+
+    std::mutex connectionLock;
+    std::mutex serviceLock;
+
+    TransferScheduler scheduler;
 
 };
 
@@ -95,8 +653,14 @@ struct WinUDPSocket : public UDPSocket
     bool create(const std::string address) override;
     bool socketBind(const std::string address, const unsigned int port) const override;
     bool socketSend(const Message* message, const std::string address, const unsigned int port) const override;
+    bool sendDatagram(const char* data, const uint64_t size, const std::string address, const unsigned int port) const override;
 
     Message* receive() const override;
+    int64_t receiveDatagram(char* buffer, const uint64_t size, std::string& address, unsigned int& port) const override;
+
+    SocketHandle getHandle() const override;
+    unsigned int getPort() const override;
+    bool setBlocking(const bool blocking) const override;
 
     bool destroy() override;
     bool isAlive() const override;
@@ -108,19 +672,37 @@ private:
 
 struct WinTCPSocket : public TCPSocket
 {
+    WinTCPSocket();
+    WinTCPSocket(const SOCKET socketHandle);
+
     bool create() override;
     bool socketBind(const std::string address, const unsigned int port) const override;
     bool socketConnect(const std::string address, const unsigned int port) const override;
     bool socketListen() const override;
     bool socketAccept() override;
+    TCPSocket* acceptConnection() const override;
     bool socketSend(const Message* message) const override;
+    bool sendPayload(const char* data, const uint64_t size) const override;
+    bool sendVectored(const char* header, const uint64_t headerSize, const char* data, const uint64_t size) const override;
+    bool sendFileRange(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const override;
 
-    Message* receive() const override;
+    bool receivePayload(char* buffer, const uint64_t size) const override;
+    bool receiveToFile(const File& file, const uint64_t offset, const uint64_t size) const override;
+    bool receiveAvailable(std::string& buffer) const override;
+
+    SocketHandle getHandle() const override;
+    bool setBlocking(const bool blocking) const override;
+    bool setProfile(const SocketProfile profile) const override;
+    bool setBuffers(const uint64_t sendBuffer, const uint64_t receiveBuffer) const override;
+    bool getTuning(SocketTuning& tuning) const override;
 
     bool destroy() override;
     bool isAlive() const override;
 
 private:
+    bool sendAll(const char* data, const uint64_t length) const;
+    bool receiveAll(char* buffer, const uint64_t length) const;
+
     SOCKET socketHandle = INVALID_SOCKET;
 
 };
@@ -146,46 +728,137 @@ protected:
 #else
 
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <ifaddrs.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <stdlib.h>
+#include <unistd.h>
+
+#ifdef __linux__
+
+#include <sys/sendfile.h>
+
+#include "uring.h"
+
+#endif
 
 struct BSDUDPSocket : public UDPSocket
 {
     bool create(const std::string address) override;
     bool socketBind(const std::string address, const unsigned int port) const override;
     bool socketSend(const Message* message, const std::string address, const unsigned int port) const override;
+    bool sendDatagram(const char* data, const uint64_t size, const std::string address, const unsigned int port) const override;
 
     Message* receive() const override;
+    int64_t receiveDatagram(char* buffer, const uint64_t size, std::string& address, unsigned int& port) const override;
+
+    SocketHandle getHandle() const override;
+    unsigned int getPort() const override;
+    bool setBlocking(const bool blocking) const override;
 
     bool destroy() override;
     bool isAlive() const override;
 
-private:
+protected:
     int socketHandle = -1;
 
 };
 
 struct BSDTCPSocket : public TCPSocket
 {
+    BSDTCPSocket();
+    BSDTCPSocket(const int socketHandle);
+
     bool create() override;
     bool socketBind(const std::string address, const unsigned int port) const override;
     bool socketConnect(const std::string address, const unsigned int port) const override;
     bool socketListen() const override;
     bool socketAccept() override;
+    TCPSocket* acceptConnection() const override;
     bool socketSend(const Message* message) const override;
+    bool sendPayload(const char* data, const uint64_t size) const override;
+    bool sendVectored(const char* header, const uint64_t headerSize, const char* data, const uint64_t size) const override;
+    bool sendFileRange(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const override;
 
-    Message* receive() const override;
+    bool receivePayload(char* buffer, const uint64_t size) const override;
+    bool receiveToFile(const File& file, const uint64_t offset, const uint64_t size) const override;
+    bool receiveAvailable(std::string& buffer) const override;
+
+    SocketHandle getHandle() const override;
+    bool setBlocking(const bool blocking) const override;
+    bool setProfile(const SocketProfile profile) const override;
+    bool setBuffers(const uint64_t sendBuffer, const uint64_t receiveBuffer) const override;
+    bool getTuning(SocketTuning& tuning) const override;
 
     bool destroy() override;
     bool isAlive() const override;
 
-private:
+protected:
+    virtual bool sendAll(const char* data, const uint64_t length) const;
+    virtual bool sendVectors(iovec* vectors, int count) const;
+    virtual bool receiveAll(char* buffer, const uint64_t length) const;
+
+    bool sendFlagged(const char* data, const uint64_t length, const int flags) const;
+
+    bool sendFileBuffered(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const;
+    bool receiveFileBuffered(const File& file, const uint64_t offset, const uint64_t size) const;
+
+    bool growBuffer(const int option, const uint64_t size) const;
+
+    bool createPipe() const;
+
     int socketHandle = -1;
 
+#ifdef __linux__
+    mutable int pipeHandles[2] = { -1, -1 };
+#endif
+
 };
 
+#ifdef __linux__
+
+struct UringUDPSocket : public BSDUDPSocket
+{
+    bool socketSend(const Message* message, const std::string address, const unsigned int port) const override;
+
+    int64_t receiveDatagram(char* buffer, const uint64_t size, std::string& address, unsigned int& port) const override;
+
+private:
+    mutable std::vector<char> datagrams;
+
+    mutable sockaddr_in addresses[URING_DATAGRAMS];
+
+    mutable int lengths[URING_DATAGRAMS];
+
+    mutable uint64_t slotSize = 0;
+
+    mutable unsigned int staged = 0;
+    mutable unsigned int next = 0;
+
+};
+
+struct UringTCPSocket : public BSDTCPSocket
+{
+    UringTCPSocket();
+    UringTCPSocket(const int socketHandle);
+
+    TCPSocket* acceptConnection() const override;
+    bool sendFileRange(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const override;
+
+    bool receiveAvailable(std::string& buffer) const override;
+
+protected:
+    bool sendAll(const char* data, const uint64_t length) const override;
+    bool sendVectors(iovec* vectors, int count) const override;
+    bool receiveAll(char* buffer, const uint64_t length) const override;
+
+};
+
+#endif
+
 struct BSDNetworkManager : public NetworkManager
 {
     BSDNetworkManager(ErrorHandler* errorHandler);
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "compress.h"
+#include "transfer.h"
+
+#define PIPELINE_DEPTH 4
+
+#define FANOUT_WINDOW 64
+
+struct SharedChunk
+{
+    std::vector<char> data;
+    std::vector<char> compressed;
+
+    uint64_t hash = 0;
+    uint64_t compressedSize = 0;
+
+    bool ready = false;
+    bool valid = false;
+
+    std::once_flag compressing;
+};
+
+struct PipelineBlock
+{
+    Chunk chunk;
+
+    std::vector<char> data;
+    std::vector<char> output;
+
+    std::shared_ptr<SharedChunk> shared;
+
+    uint64_t compressed = 0;
+
+    std::string frame;
+};
+
+struct BlockQueue
+{
+    BlockQueue(const size_t capacity);
+
+    bool push(PipelineBlock* block);
+    bool pop(PipelineBlock*& block);
+
+    void close();
+    void abort();
+
+private:
+    const size_t capacity;
+
+    std::queue<PipelineBlock*> blocks;
+
+    bool closed = false;
+    bool aborted = false;
+
+    std::mutex lock;
+    std::condition_variable signal;
+
+};
+
+struct StageCounters
+{
+    std::string name;
+
+    unsigned int workers = 0;
+
+    uint64_t items = 0;
+
+    double busy = 0;
+    double idle = 0;
+};
+
+struct PipelineStage
+{
+    std::string name;
+
+    unsigned int workers = 0;
+
+    std::function<bool(PipelineBlock*, const unsigned int)> process;
+
+    std::atomic<uint64_t> items = 0;
+    std::atomic<uint64_t> busy = 0;
+    std::atomic<uint64_t> idle = 0;
+
+    std::atomic<unsigned int> remaining = 0;
+};
+
+struct Pipeline
+{
+    ~Pipeline();
+
+    void addStage(const std::string name, const unsigned int workers, const std::function<bool(PipelineBlock*, const unsigned int)> process);
+
+    bool run(const std::function<bool(PipelineBlock*)> next);
+
+    std::vector<StageCounters> getCounters() const;
+
+private:
+    void work(const size_t index, const unsigned int worker);
+
+    void fail();
+
+    std::vector<PipelineStage*> stages;
+    std::vector<BlockQueue*> queues;
+    std::vector<PipelineBlock*> blocks;
+
+    std::atomic<bool> failed = false;
+
+};
+
+struct ChunkCache
+{
+    ChunkCache(const size_t window);
+
+    std::shared_ptr<SharedChunk> acquire(const File& file, const std::string source, const Chunk& chunk);
+
+    uint64_t compress(SharedChunk* shared, const Chunk& chunk, Compressor& compressor);
+
+private:
+    const size_t window;
+
+    std::unordered_map<std::string, std::shared_ptr<SharedChunk>> chunks;
+
+    std::deque<std::string> order;
+
+    std::mutex lock;
+    std::condition_variable signal;
+
+};
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "json.h"
+
+#define MESSAGE_FIELD_LIMIT 8
+
+enum MessageType
+{
+    MessageUnknown = 0,
+    MessageBroadcast = 1,
+    MessageAvailable = 2,
+    MessageResponse = 3,
+    MessageConnect = 4,
+    MessageTransfer = 5,
+    MessageStream = 6,
+    MessageResume = 7,
+    MessageChunk = 8,
+    MessageBundle = 9,
+    MessageReady = 10,
+    MessageBatch = 11,
+    MessageHashes = 12,
+    MessageSignature = 13,
+    MessageLiteral = 14,
+    MessageCopy = 15,
+    MessageStore = 16,
+    MessageOffer = 17,
+    MessageMissing = 18,
+    MessageData = 19,
+    MessageComplete = 20,
+    MessageReceived = 21,
+    MessageTypeCount = 22
+};
+
+enum MessageField
+{
+    FieldNone = 0,
+    FieldName = 1,
+    FieldIp = 2,
+    FieldId = 3,
+    FieldKey = 4,
+    FieldFile = 5,
+    FieldSize = 6,
+    FieldStreams = 7,
+    FieldKind = 8,
+    FieldCodecs = 9,
+    FieldCodec = 10,
+    FieldTransports = 11,
+    FieldTransport = 12,
+    FieldPort = 13,
+    FieldToken = 14,
+    FieldOffset = 15,
+    FieldHash = 16,
+    FieldRoot = 17,
+    FieldBlock = 18,
+    FieldCount = 19,
+    FieldIndex = 20,
+    MessageFieldCount = 21
+};
+
+enum FieldEncoding
+{
+    EncodedString = 0,
+    EncodedInteger = 1
+};
+
+struct FieldDescriptor
+{
+    const char* name;
+
+    FieldEncoding encoding;
+};
+
+struct MessageDescriptor
+{
+    const char* name;
+
+    MessageField required[MESSAGE_FIELD_LIMIT];
+    MessageField optional[MESSAGE_FIELD_LIMIT];
+};
+
+// Every field list ends at the first FieldNone.
+
+constexpr FieldDescriptor FIELD_DESCRIPTORS[] =
+{
+    { "", FieldEncoding::EncodedString },
+    { "name", FieldEncoding::EncodedString },
+    { "ip", FieldEncoding::EncodedString },
+    { "id", FieldEncoding::EncodedString },
+    { "key", FieldEncoding::EncodedInteger },
+    { "file", FieldEncoding::EncodedString },
+    { "size", FieldEncoding::EncodedInteger },
+    { "streams", FieldEncoding::EncodedInteger },
+    { "kind", FieldEncoding::EncodedString },
+    { "codecs", FieldEncoding::EncodedString },
+    { "codec", FieldEncoding::EncodedString },
+    { "transports", FieldEncoding::EncodedString },
+    { "transport", FieldEncoding::EncodedString },
+    { "port", FieldEncoding::EncodedInteger },
+    { "token", FieldEncoding::EncodedInteger },
+    { "offset", FieldEncoding::EncodedInteger },
+    { "hash", FieldEncoding::EncodedInteger },
+    { "root", FieldEncoding::EncodedInteger },
+    { "block", FieldEncoding::EncodedInteger },
+    { "count", FieldEncoding::EncodedInteger },
+    { "index", FieldEncoding::EncodedInteger }
+};
+
+constexpr MessageDescriptor MESSAGE_DESCRIPTORS[] =
+{
+    { "", {}, {} },
+    { "broadcast", { FieldIp }, { FieldName } },
+    { "available", { FieldName, FieldIp }, {} },
+    { "response", { FieldName, FieldIp }, {} },
+    { "connect", { FieldIp }, {} },
+    { "transfer", { FieldIp, FieldId, FieldKey, FieldFile, FieldSize, FieldStreams }, { FieldName, FieldKind, FieldCodecs, FieldTransports } },
+    { "stream", { FieldIp, FieldId }, {} },
+    { "resume", {}, { FieldCodec, FieldTransport, FieldPort, FieldToken } },
+    { "chunk", { FieldOffset, FieldSize }, {} },
+    { "bundle", { FieldIp, FieldKey, FieldSize }, { FieldName, FieldCodecs } },
+    { "ready", {}, { FieldCodec } },
+    { "batch", { FieldSize, FieldHash }, {} },
+    { "hashes", { FieldRoot }, {} },
+    { "signature", { FieldBlock }, {} },
+    { "literal", { FieldOffset }, {} },
+    { "copy", { FieldOffset, FieldBlock, FieldCount }, {} },
+    { "store", {}, {} },
+    { "offer", {}, {} },
+    { "missing", {}, {} },
+    { "data", { FieldIndex }, {} },
+    { "complete", {}, {} },
+    { "received", {}, {} }
+};
+
+static_assert(sizeof(FIELD_DESCRIPTORS) / sizeof(FieldDescriptor) == MessageField::MessageFieldCount, "Every message field needs a descriptor.");
+static_assert(sizeof(MESSAGE_DESCRIPTORS) / sizeof(MessageDescriptor) == MessageType::MessageTypeCount, "Every message type needs a descriptor.");
+
+struct ProtocolMessage
+{
+    ProtocolMessage();
+    ProtocolMessage(const MessageType type);
+
+    static bool decode(const JSONView& view, ProtocolMessage& message);
+
+    void encode(std::string& buffer) const;
+
+    void setString(const MessageField field, const std::string_view value);
+    void setInteger(const MessageField field, const uint64_t value);
+
+    bool has(const MessageField field) const;
+
+    std::string_view getString(const MessageField field) const;
+    uint64_t getInteger(const MessageField field) const;
+
+    MessageType type = MessageType::MessageUnknown;
+
+    std::string_view typeName;
+
+private:
+    void encodeField(std::string& buffer, const MessageField field) const;
+
+    std::string_view strings[MessageField::MessageFieldCount];
+
+    uint64_t integers[MessageField::MessageFieldCount];
+
+    uint32_t present = 0;
+
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+
+#include <WinSock2.h>
+
+typedef SOCKET SocketHandle;
+
+#else
+
+#include <poll.h>
+#include <unistd.h>
+
+#ifdef __linux__
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#endif
+
+typedef int SocketHandle;
+
+#endif
+
+#define REACTOR_EVENTS 64
+#define REACTOR_INTERVAL 50
+
+enum ReactorEvent
+{
+    Readable = 1,
+    Writable = 2,
+    Hangup = 4
+};
+
+struct ReactorWatch
+{
+    unsigned int events = 0;
+
+    std::function<void(const unsigned int)> callback;
+};
+
+struct ReactorTimer
+{
+    std::chrono::time_point<std::chrono::steady_clock> due;
+
+    unsigned int interval = 0;
+
+    bool repeat = false;
+
+    std::function<void()> callback;
+};
+
+struct Reactor
+{
+    ~Reactor();
+
+    bool start();
+    void stop();
+
+    bool watch(const SocketHandle handle, const unsigned int events, const std::function<void(const unsigned int)> callback);
+    void unwatch(const SocketHandle handle);
+
+    uint64_t addTimer(const unsigned int interval, const bool repeat, const std::function<void()> callback);
+    void cancelTimer(const uint64_t timer);
+
+    void post(const std::function<void()> function);
+    void synchronize();
+
+private:
+    void run();
+    void wait(const int timeout, std::vector<std::pair<SocketHandle, unsigned int>>& ready);
+    void wake() const;
+
+    int getTimeout();
+
+    std::unordered_map<SocketHandle, ReactorWatch> watches;
+    std::map<uint64_t, ReactorTimer> timers;
+    std::vector<std::function<void()>> posted;
+
+    uint64_t nextTimer = 1;
+
+    std::atomic<bool> running = false;
+
+    std::mutex lock;
+
+    std::thread thread;
+
+#ifdef __linux__
+    int pollHandle = -1;
+    int wakeHandle = -1;
+#endif
+
+};
@@ -22,12 +22,16 @@
 
 struct Target
 {
-    Target(const GUIObject* object, const std::string name, const std::string ip);
+    Target(const GUIObject* object, Button* button, const std::string name, const std::string ip);
 
     const GUIObject* object;
 
+    Button* button;
+
     const std::string name;
     const std::string ip;
+
+    std::string status = "Send";
 };
 
 struct Renderer
@@ -35,10 +39,10 @@ struct Renderer
     Renderer(MainThreadQueue* mainThreadQueue, ErrorHandler* errorHandler, NetworkManager* networkManager, FileManager* fileManager);
     ~Renderer();
 
-    void setPath(const std::string path);
+    void setPaths(const std::vector<std::filesystem::path> paths);
 
     void setupMain();
-    void setupReceive(const std::string name, const std::string& data);
+    void setupReceive(const std::string name, ReceiveResult* result);
 
     void run();
     void render();
@@ -47,6 +51,7 @@ struct Renderer
 
 private:
     void handleResponse(const std::string name, const std::string ip);
+    void updateTargets();
 
     std::mutex renderLock;
 
@@ -73,7 +78,7 @@ private:
 
     std::vector<Target*> targets;
 
-    std::string path;
+    std::vector<std::filesystem::path> paths;
 
 };
 
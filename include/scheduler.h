@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "defaults.h"
+#include "pipeline.h"
+#include "shaper.h"
+#include "tuning.h"
+
+#define TRANSFER_HISTORY 32
+
+enum TransferState
+{
+    TransferQueued,
+    TransferActive,
+    TransferComplete,
+    TransferFailed
+};
+
+struct TransferStatus
+{
+    uint64_t id = 0;
+
+    std::string ip;
+    std::string name;
+
+    TransferState state = TransferState::TransferQueued;
+
+    uint64_t sent = 0;
+    uint64_t size = 0;
+
+    uint64_t bandwidth = 0;
+
+    std::vector<SocketTuning> connections;
+};
+
+struct TransferJob
+{
+    TransferJob(const uint64_t id, const std::vector<std::filesystem::path> paths, const std::string ip, const std::shared_ptr<ChunkCache> cache, const std::shared_ptr<TokenBucket> peer, TokenBucket* global);
+
+    void pace(const uint64_t bytes);
+    void setBandwidth(const uint64_t bandwidth);
+    void setConnections(const std::vector<SocketTuning> connections);
+
+    bool isShaped();
+
+    TransferStatus getStatus();
+
+    const uint64_t id;
+
+    const std::vector<std::filesystem::path> paths;
+
+    const std::string ip;
+
+    const std::shared_ptr<ChunkCache> cache;
+
+    TransferState state = TransferState::TransferQueued;
+
+    std::atomic<uint64_t> size = 0;
+    std::atomic<uint64_t> sent = 0;
+
+    bool limited = false;
+
+private:
+    TokenBucket bucket;
+
+    const std::shared_ptr<TokenBucket> peer;
+
+    TokenBucket* global;
+
+    std::vector<SocketTuning> connections;
+
+    std::mutex lock;
+
+};
+
+struct TransferScheduler
+{
+    TransferScheduler(const std::function<bool(TransferJob*)> run);
+    ~TransferScheduler();
+
+    uint64_t enqueue(const std::vector<std::filesystem::path> paths, const std::string ip, const std::shared_ptr<ChunkCache> cache);
+
+    void setConcurrency(const unsigned int concurrency);
+    void setBandwidth(const uint64_t bandwidth);
+    void setPeerBandwidth(const uint64_t bandwidth);
+    void setPeerBandwidth(const std::string ip, const uint64_t bandwidth);
+    void setTransferBandwidth(const uint64_t bandwidth);
+    void setTransferBandwidth(const uint64_t id, const uint64_t bandwidth);
+
+    std::vector<TransferStatus> getTransfers();
+
+private:
+    void work();
+    void prune();
+
+    TransferJob* next();
+
+    std::shared_ptr<TokenBucket> getPeer(const std::string ip);
+
+    const std::function<bool(TransferJob*)> run;
+
+    std::deque<TransferJob*> jobs;
+
+    std::vector<std::thread> workers;
+
+    TokenBucket global;
+
+    std::unordered_map<std::string, std::shared_ptr<TokenBucket>> peers;
+    std::unordered_map<std::string, uint64_t> peerLimits;
+
+    unsigned int concurrency = TRANSFER_CONCURRENCY;
+    unsigned int active = 0;
+
+    uint64_t peerBandwidth = 0;
+    uint64_t transferBandwidth = 0;
+    uint64_t nextJob = 1;
+
+    bool stopping = false;
+
+    std::mutex lock;
+
+    std::condition_variable signal;
+
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#define SHAPER_BURST 65536
+#define SHAPER_QUANTUM 16384
+
+struct TokenBucket
+{
+    void setRate(const uint64_t rate);
+
+    uint64_t getRate();
+
+    std::chrono::time_point<std::chrono::steady_clock> reserve(const uint64_t bytes);
+
+private:
+    uint64_t rate = 0;
+
+    std::chrono::time_point<std::chrono::steady_clock> ready;
+
+    std::mutex lock;
+
+};
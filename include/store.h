@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "hash.h"
+#include "transfer.h"
+
+#define STORE_MIN_CHUNK 8192
+#define STORE_AVERAGE_CHUNK 65536
+#define STORE_MAX_CHUNK 262144
+
+#define STORE_MASK_SMALL 0xffffc00000000000ull
+#define STORE_MASK_LARGE 0xfffc000000000000ull
+
+#define STORE_INDEX_MAGIC "SQX1"
+#define STORE_HEADER_SIZE 20
+#define STORE_SLOT_SIZE 48
+#define STORE_INITIAL_SLOTS 65536
+#define STORE_MAX_LOAD 50
+
+#define STORE_OFFER_SIZE 36
+
+struct StoredChunk
+{
+    std::string hash;
+
+    uint64_t offset = 0;
+    uint32_t size = 0;
+};
+
+struct ContentChunker
+{
+    ContentChunker();
+
+    bool split(const File& file, const uint64_t size, std::vector<StoredChunk>& chunks) const;
+
+    static std::string encode(const std::vector<StoredChunk>& chunks);
+    static bool decode(const std::string& data, const uint64_t size, std::vector<StoredChunk>& chunks);
+
+private:
+    size_t cut(const unsigned char* data, const size_t size) const;
+
+    uint64_t gear[256];
+
+};
+
+struct ChunkStore
+{
+    ChunkStore(const std::filesystem::path directory);
+
+    bool isOpen() const;
+
+    bool contains(const std::string& hash);
+    bool read(const std::string& hash, char* buffer, const uint32_t size);
+    bool insert(const std::string& hash, const char* data, const uint32_t size);
+
+    bool flush();
+
+    uint64_t getCount() const;
+
+private:
+    bool open();
+    bool create(File& file, const uint64_t slots) const;
+
+    bool find(const File& file, const uint64_t slots, const std::string& hash, uint64_t& slot, bool& found, char* record) const;
+    bool grow();
+
+    bool writeHeader();
+
+    const std::filesystem::path indexPath;
+    const std::filesystem::path packPath;
+
+    File index;
+    File pack;
+
+    uint64_t capacity = 0;
+    uint64_t count = 0;
+    uint64_t packSize = 0;
+
+    std::mutex lock;
+
+};
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "defaults.h"
+#include "hash.h"
+
+#define CHUNK_SIZE 1048576
+
+#define JOURNAL_MAGIC "SQJ1"
+#define JOURNAL_HEADER_SIZE 12
+#define JOURNAL_INTERVAL 64
+
+struct File
+{
+    ~File();
+
+    bool openRead(const std::filesystem::path path);
+    bool openWrite(const std::filesystem::path path, const bool truncate);
+
+    bool readAt(char* buffer, const uint64_t size, const uint64_t offset) const;
+    bool writeAt(const char* data, const uint64_t size, const uint64_t offset) const;
+
+    bool allocate(const uint64_t size) const;
+    bool sync() const;
+    bool close();
+    bool isOpen() const;
+
+    uint64_t getSize() const;
+
+    int getDescriptor() const;
+
+private:
+    int descriptor = -1;
+
+};
+
+struct Chunk
+{
+    uint64_t offset = 0;
+    size_t size = 0;
+};
+
+struct ChunkReader
+{
+    ChunkReader(const std::filesystem::path path);
+
+    bool isOpen() const;
+    bool isComplete() const;
+
+    uint64_t getSize() const;
+
+    std::filesystem::path getPath() const;
+
+    const File& getFile() const;
+
+    void skip(const std::vector<bool>& completed);
+
+    bool next(Chunk& chunk);
+
+private:
+    const std::filesystem::path path;
+
+    File file;
+
+    uint64_t size = 0;
+    uint64_t offset = 0;
+
+    std::vector<bool> skipped;
+
+    std::mutex lock;
+
+};
+
+struct ChunkMap
+{
+    ChunkMap(const uint64_t size);
+    ChunkMap(const uint64_t size, const std::vector<bool>& completed);
+
+    static std::string encode(const std::vector<bool>& chunks);
+    static bool decode(const std::string& bitmap, std::vector<bool>& chunks);
+
+    bool mark(const uint64_t offset, const uint64_t size);
+
+    bool isComplete() const;
+
+private:
+    const uint64_t size;
+
+    std::vector<bool> chunks;
+
+    uint64_t remaining;
+
+    std::mutex lock;
+
+};
+
+struct ChunkHasher
+{
+    ChunkHasher(const File& file, const uint64_t size);
+    ~ChunkHasher();
+
+    void push(const uint64_t offset);
+    void record(const uint64_t offset, const uint64_t hash);
+    void pushAll();
+
+    bool finish(std::vector<uint64_t>& hashes);
+
+    static std::string encode(const std::vector<uint64_t>& hashes);
+    static bool decode(const std::string& data, std::vector<uint64_t>& hashes);
+
+private:
+    void run();
+
+    const File& file;
+    const uint64_t size;
+
+    std::vector<uint64_t> hashes;
+    std::vector<bool> hashed;
+
+    std::queue<uint64_t> pending;
+
+    bool closed = false;
+    bool failed = false;
+
+    std::mutex lock;
+    std::condition_variable signal;
+
+    std::thread thread;
+
+};
+
+struct StreamTuner
+{
+    unsigned int choose() const;
+
+    void record(const unsigned int streams, const double throughput);
+
+private:
+    double throughputs[MAX_STREAMS + 1] = {};
+
+};
+
+struct ReceiveResult
+{
+    virtual ~ReceiveResult() = default;
+
+    virtual std::string getName() const = 0;
+
+    virtual bool commit(const std::filesystem::path path) = 0;
+    virtual void discard() = 0;
+};
+
+struct ReceiveSink : public ReceiveResult
+{
+    ReceiveSink(const std::filesystem::path directory, const std::string name, const uint64_t key, const uint64_t size);
+
+    bool isOpen() const;
+    bool isComplete() const;
+
+    uint64_t getKey() const;
+    uint64_t getSize() const;
+
+    const File& getFile() const;
+
+    std::vector<bool> getCompleted();
+
+    bool checkpoint(const uint64_t offset);
+    bool flush();
+
+    std::string getName() const override;
+
+    bool commit(const std::filesystem::path path) override;
+    void discard() override;
+
+private:
+    bool resume();
+    bool create();
+
+    bool flushPending();
+
+    const std::string name;
+    const uint64_t key;
+    const uint64_t size;
+
+    const std::filesystem::path tempPath;
+    const std::filesystem::path journalPath;
+
+    File file;
+    File journal;
+
+    uint64_t journalSize = 0;
+
+    std::vector<bool> completed;
+    std::vector<uint64_t> pending;
+
+    uint64_t remaining = 0;
+
+    std::mutex lock;
+
+};
+
+struct StagedResult : public ReceiveResult
+{
+    StagedResult(const std::filesystem::path path);
+
+    std::string getName() const override;
+
+    bool commit(const std::filesystem::path path) override;
+    void discard() override;
+
+private:
+    const std::filesystem::path path;
+
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#define TUNE_INTERVAL 250
+#define TUNE_ROUNDS 4
+#define TUNE_MIN_BUFFER 262144
+#define TUNE_MAX_BUFFER 67108864
+#define TUNE_NOTSENT_LOWAT 131072
+
+enum SocketProfile
+{
+    SocketControl,
+    SocketBulk
+};
+
+struct SocketTuning
+{
+    SocketProfile profile = SocketProfile::SocketBulk;
+
+    double roundTrip = 0;
+    double throughput = 0;
+
+    uint64_t sendBuffer = 0;
+    uint64_t receiveBuffer = 0;
+    uint64_t notSentLowWater = 0;
+
+    bool noDelay = false;
+};
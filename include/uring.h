@@ -0,0 +1,72 @@
+#pragma once
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define URING_ENTRIES 32
+#define URING_BUFFERS 2
+#define URING_BUFFER_SIZE 262144
+#define URING_DATAGRAMS 16
+
+struct IoRing
+{
+    ~IoRing();
+
+    static bool isSupported();
+    static IoRing* getLocal();
+
+    bool create(const unsigned int entries);
+    bool registerBuffers(const unsigned int count, const uint64_t size);
+
+    char* getBuffer(const unsigned int index) const;
+
+    io_uring_sqe* prepare(const uint8_t opcode, const int handle, const void* address, const uint32_t length, const uint64_t offset, const uint64_t tag);
+
+    bool wait(const unsigned int count, int* results);
+
+    int execute();
+
+private:
+    bool submit(const unsigned int minimum);
+    bool complete(uint64_t& tag, int& result);
+
+    int descriptor = -1;
+
+    void* ringMemory = MAP_FAILED;
+    void* entryMemory = MAP_FAILED;
+
+    uint64_t ringMemorySize = 0;
+    uint64_t entryMemorySize = 0;
+
+    unsigned int* submissionHead = nullptr;
+    unsigned int* submissionTail = nullptr;
+    unsigned int* submissionArray = nullptr;
+    unsigned int* completionHead = nullptr;
+    unsigned int* completionTail = nullptr;
+
+    unsigned int submissionMask = 0;
+    unsigned int completionMask = 0;
+    unsigned int capacity = 0;
+    unsigned int pending = 0;
+
+    io_uring_sqe* submissions = nullptr;
+    io_uring_cqe* completions = nullptr;
+
+    std::vector<char*> buffers;
+
+    uint64_t bufferSize = 0;
+
+};
+
+#endif
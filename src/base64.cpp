@@ -2,41 +2,59 @@
 
 std::string Base64::encode(const std::string str)
 {
-    const unsigned int truncated = str.size() - (str.size() % 3);
+    std::string result;
+
+    encode(str.data(), str.size(), result);
+
+    return result;
+}
 
+std::string Base64::decode(const std::string str)
+{
     std::string result;
 
-    for (unsigned int i = 0; i < truncated; i += 3)
+    decode(str, result);
+
+    return result;
+}
+
+void Base64::encode(const char* data, const size_t size, std::string& result)
+{
+    const size_t truncated = size - (size % 3);
+
+    result.clear();
+    result.reserve((size + 2) / 3 * 4);
+
+    for (size_t i = 0; i < truncated; i += 3)
     {
-        result += ALPHABET[(str[i] >> 2) & 0b00111111];
-        result += ALPHABET[((str[i] & 0b00000011) << 4) | ((str[i + 1] >> 4) & 0b00001111)];
-        result += ALPHABET[((str[i + 1] & 0b00001111) << 2) | ((str[i + 2] >> 6) & 0b00000011)];
-        result += ALPHABET[str[i + 2] & 0b00111111];
+        result += ALPHABET[(data[i] >> 2) & 0b00111111];
+        result += ALPHABET[((data[i] & 0b00000011) << 4) | ((data[i + 1] >> 4) & 0b00001111)];
+        result += ALPHABET[((data[i + 1] & 0b00001111) << 2) | ((data[i + 2] >> 6) & 0b00000011)];
+        result += ALPHABET[data[i + 2] & 0b00111111];
     }
 
-    if (str.size() - truncated == 1)
+    if (size - truncated == 1)
     {
-        result += ALPHABET[(str[truncated] >> 2) & 0b00111111];
-        result += ALPHABET[(str[truncated] & 0b00000011) << 4];
+        result += ALPHABET[(data[truncated] >> 2) & 0b00111111];
+        result += ALPHABET[(data[truncated] & 0b00000011) << 4];
     }
 
-    else if (str.size() - truncated == 2)
+    else if (size - truncated == 2)
     {
-        result += ALPHABET[(str[truncated] >> 2) & 0b00111111];
-        result += ALPHABET[((str[truncated] & 0b00000011) << 4) | ((str[truncated + 1] >> 4) & 0b00001111)];
-        result += ALPHABET[(str[truncated + 1] & 0b00001111) << 2];
+        result += ALPHABET[(data[truncated] >> 2) & 0b00111111];
+        result += ALPHABET[((data[truncated] & 0b00000011) << 4) | ((data[truncated + 1] >> 4) & 0b00001111)];
+        result += ALPHABET[(data[truncated + 1] & 0b00001111) << 2];
     }
-
-    return result;
 }
 
-std::string Base64::decode(const std::string str)
+void Base64::decode(const std::string& str, std::string& result)
 {
-    const unsigned int truncated = str.size() - (str.size() % 4);
+    const size_t truncated = str.size() - (str.size() % 4);
 
-    std::string result;
+    result.clear();
+    result.reserve(str.size() / 4 * 3 + 2);
 
-    for (unsigned int i = 0; i < truncated; i += 4)
+    for (size_t i = 0; i < truncated; i += 4)
     {
         result += (base64ToAscii(str[i]) << 2) | ((base64ToAscii(str[i + 1]) >> 4) & 0b00000011);
         result += (base64ToAscii(str[i + 1]) << 4) | ((base64ToAscii(str[i + 2]) >> 2) & 0b00001111);
@@ -53,8 +71,6 @@ std::string Base64::decode(const std::string str)
         result += (base64ToAscii(str[truncated]) << 2) | ((base64ToAscii(str[truncated + 1]) >> 4) & 0b00000011);
         result += (base64ToAscii(str[truncated + 1]) << 4) | ((base64ToAscii(str[truncated + 2]) >> 2) & 0b00001111);
     }
-
-    return result;
 }
 
 char Base64::base64ToAscii(const char c)
@@ -0,0 +1,292 @@
+#include "../include/benchmark.h"
+
+// The stream parser JSONView replaced, kept as the benchmark baseline.
+
+static JSONObject* legacyDeserialize(std::stringstream& stream)
+{
+    stream.get();
+
+    std::unordered_map<std::string, const JSONObject*> properties;
+
+    while (stream.peek() != '}' && !stream.eof())
+    {
+        std::string name;
+
+        while (stream.peek() != ':' && !stream.eof())
+        {
+            name += stream.get();
+        }
+
+        if (stream.eof() || properties.count(name))
+        {
+            return nullptr;
+        }
+
+        stream.get();
+
+        const JSONObject* value = nullptr;
+
+        if (stream.peek() == '"')
+        {
+            stream.get();
+
+            std::string str;
+
+            while (stream.peek() != '"' && !stream.eof())
+            {
+                str += stream.get();
+            }
+
+            if (stream.eof())
+            {
+                return nullptr;
+            }
+
+            stream.get();
+
+            value = new JSONString(str);
+        }
+
+        else if (stream.peek() == '{')
+        {
+            value = legacyDeserialize(stream);
+        }
+
+        if (!value)
+        {
+            return nullptr;
+        }
+
+        properties[name] = value;
+
+        if (stream.peek() == ',')
+        {
+            stream.get();
+        }
+
+        else if (stream.peek() != '}')
+        {
+            return nullptr;
+        }
+    }
+
+    if (stream.eof())
+    {
+        return nullptr;
+    }
+
+    stream.get();
+
+    return new JSONObject(properties);
+}
+
+BenchmarkRunner::BenchmarkRunner(ErrorHandler* errorHandler, NetworkManager* networkManager) :
+    errorHandler(errorHandler), networkManager(networkManager) {}
+
+void BenchmarkRunner::run(const std::filesystem::path path, const unsigned int streams) const
+{
+    const std::filesystem::path file = path.empty() ? createFile() : path;
+
+    if (file.empty())
+    {
+        errorHandler->handle(SquirrelFileException("Failed to create benchmark file."));
+
+        return;
+    }
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "squirrel-benchmark-receive";
+
+    std::error_code error;
+
+    std::filesystem::create_directories(directory, error);
+
+    if (error)
+    {
+        errorHandler->handle(SquirrelFileException("Failed to create benchmark directory."));
+
+        return;
+    }
+
+    runParser();
+
+    const std::string address = networkManager->getLocalAddress();
+    const uint64_t size = std::filesystem::file_size(file);
+    const unsigned int maxStreams = streams > 0 ? streams : MAX_STREAMS;
+
+    std::cout << "Transferring " << size / 1048576 << " MB over loopback.\n";
+
+    for (unsigned int count = 1; count <= maxStreams; count *= 2)
+    {
+        ReceiveResult* sink = nullptr;
+
+        const std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+
+        std::thread receiver([&]()
+        {
+            sink = networkManager->receiveFile(address, BENCHMARK_PORT, directory);
+        });
+
+        const bool sent = networkManager->sendFile(file, address, BENCHMARK_PORT, count, nullptr);
+
+        receiver.join();
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const bool received = sink != nullptr;
+
+        if (sink)
+        {
+            sink->discard();
+
+            delete sink;
+        }
+
+        if (!sent || !received)
+        {
+            break;
+        }
+
+        std::cout << count << (count == 1 ? " stream: " : " streams: ") << (uint64_t)(size / seconds / 1048576) << " MB/s\n";
+
+        for (const StageCounters& counter : networkManager->getPipelineCounters())
+        {
+            std::cout << "    " << counter.name << ": " << counter.items << " chunks, " << (uint64_t)(counter.busy * 1000) << " ms busy, " << (uint64_t)(counter.idle * 1000) << " ms idle over " << counter.workers << (counter.workers == 1 ? " worker\n" : " workers\n");
+        }
+
+        for (const SocketTuning& tuning : networkManager->getConnectionTunings())
+        {
+            std::cout << "    socket: " << tuning.sendBuffer / 1024 << " KB send, " << tuning.receiveBuffer / 1024 << " KB receive, " << tuning.notSentLowWater / 1024 << " KB unsent limit, " << (tuning.noDelay ? "no delay, " : "delayed, ") << (uint64_t)(tuning.roundTrip * 1000000) << " us round trip, " << (uint64_t)(tuning.throughput / 1048576) << " MB/s measured\n";
+        }
+    }
+
+    std::filesystem::remove_all(directory, error);
+
+    if (path.empty())
+    {
+        std::filesystem::remove(file);
+    }
+}
+
+void BenchmarkRunner::runParser() const
+{
+    const Message* header = new Message(new JSONObject(
+    {
+        { "type", new JSONString("chunk") },
+        { "offset", new JSONString(std::to_string(BENCHMARK_SIZE - CHUNK_SIZE)) },
+        { "size", new JSONString(std::to_string(CHUNK_SIZE)) }
+    }));
+
+    std::string text;
+
+    header->data->serialize(text);
+
+    delete header;
+
+    uint64_t legacyTotal = 0;
+    uint64_t arenaTotal = 0;
+    uint64_t viewTotal = 0;
+    uint64_t codecTotal = 0;
+
+    std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < BENCHMARK_MESSAGES; i++)
+    {
+        std::stringstream stream(text);
+
+        const JSONObject* object = legacyDeserialize(stream);
+
+        legacyTotal += object->getProperty("offset")->asInteger().value_or(0) + object->getProperty("size")->asInteger().value_or(0) + object->getProperty("type")->asString().value_or("").size();
+
+        delete object;
+    }
+
+    const double legacy = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < BENCHMARK_MESSAGES; i++)
+    {
+        JSONView view;
+
+        JSONView::deserialize(text, view);
+
+        const Message* message = new Message(view, 0, 0);
+
+        arenaTotal += message->data->getProperty("offset")->asInteger().value_or(0) + message->data->getProperty("size")->asInteger().value_or(0) + message->data->getProperty("type")->asString().value_or("").size();
+
+        delete message;
+    }
+
+    const double arena = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < BENCHMARK_MESSAGES; i++)
+    {
+        JSONView view;
+
+        JSONView::deserialize(text, view);
+
+        viewTotal += view.getProperty("offset").asInteger().value_or(0) + view.getProperty("size").asInteger().value_or(0) + view.getProperty("type").asString().value_or("").size();
+    }
+
+    const double view = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < BENCHMARK_MESSAGES; i++)
+    {
+        JSONView view;
+
+        ProtocolMessage message;
+
+        JSONView::deserialize(text, view);
+        ProtocolMessage::decode(view, message);
+
+        codecTotal += message.getInteger(MessageField::FieldOffset) + message.getInteger(MessageField::FieldSize) + message.typeName.size();
+    }
+
+    const double codec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (legacyTotal != viewTotal || arenaTotal != viewTotal || codecTotal != viewTotal)
+    {
+        errorHandler->handle(SquirrelException("Parsers disagree on benchmark message."));
+
+        return;
+    }
+
+    std::cout << "Parsing " << BENCHMARK_MESSAGES << " chunk headers: " << (uint64_t)(legacy * 1000000000 / BENCHMARK_MESSAGES) << " ns stream, " << (uint64_t)(arena * 1000000000 / BENCHMARK_MESSAGES) << " ns arena, " << (uint64_t)(view * 1000000000 / BENCHMARK_MESSAGES) << " ns view, " << (uint64_t)(codec * 1000000000 / BENCHMARK_MESSAGES) << " ns codec per message.\n";
+}
+
+std::filesystem::path BenchmarkRunner::createFile() const
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "squirrel-benchmark";
+
+    std::ofstream file(path, std::ios::binary);
+
+    if (!file.is_open())
+    {
+        return "";
+    }
+
+    std::mt19937_64 generator;
+
+    std::vector<uint64_t> buffer(CHUNK_SIZE / sizeof(uint64_t));
+
+    for (uint64_t written = 0; written < BENCHMARK_SIZE; written += CHUNK_SIZE)
+    {
+        for (uint64_t& value : buffer)
+        {
+            value = generator();
+        }
+
+        file.write((const char*)buffer.data(), CHUNK_SIZE);
+    }
+
+    if (!file.good())
+    {
+        return "";
+    }
+
+    return path;
+}
@@ -0,0 +1,496 @@
+#include "../include/bundle.h"
+
+static void writeInteger(char* buffer, const uint64_t value, const unsigned int size)
+{
+    for (unsigned int i = 0; i < size; i++)
+    {
+        buffer[i] = (value >> (i * 8)) & 0xff;
+    }
+}
+
+static uint64_t readInteger(const char* buffer, const unsigned int size)
+{
+    uint64_t value = 0;
+
+    for (unsigned int i = 0; i < size; i++)
+    {
+        value |= (uint64_t)(unsigned char)buffer[i] << (i * 8);
+    }
+
+    return value;
+}
+
+bool ManifestEntry::isBatched() const
+{
+    return type == EntryType::FileEntry && size < BATCH_THRESHOLD;
+}
+
+bool Manifest::add(const std::filesystem::path path)
+{
+    const std::filesystem::path root = path.filename().empty() ? path.parent_path() : path;
+    const std::string name = root.filename().string();
+
+    std::error_code error;
+
+    if (std::filesystem::is_regular_file(root, error))
+    {
+        return addEntry(root, name);
+    }
+
+    if (!std::filesystem::is_directory(root, error) || !addEntry(root, name))
+    {
+        return false;
+    }
+
+    std::filesystem::recursive_directory_iterator iterator(root, std::filesystem::directory_options::skip_permission_denied, error);
+
+    if (error)
+    {
+        return false;
+    }
+
+    for (; iterator != std::filesystem::recursive_directory_iterator(); iterator.increment(error))
+    {
+        if (error)
+        {
+            return false;
+        }
+
+        if (iterator->is_symlink(error))
+        {
+            iterator.disable_recursion_pending();
+
+            continue;
+        }
+
+        if (!iterator->is_regular_file(error) && !iterator->is_directory(error))
+        {
+            continue;
+        }
+
+        if (!addEntry(iterator->path(), name + "/" + iterator->path().lexically_relative(root).generic_string()))
+        {
+            return false;
+        }
+    }
+
+    return !error;
+}
+
+std::string Manifest::encode() const
+{
+    std::string data;
+
+    for (const ManifestEntry& entry : entries)
+    {
+        char header[MANIFEST_ENTRY_HEADER_SIZE];
+
+        writeInteger(header, entry.type, 1);
+        writeInteger(header + 1, entry.mode, 4);
+        writeInteger(header + 5, entry.size, 8);
+        writeInteger(header + 13, entry.name.size(), 2);
+
+        data.append(header, MANIFEST_ENTRY_HEADER_SIZE);
+        data.append(entry.name);
+    }
+
+    return data;
+}
+
+bool Manifest::decode(const std::string& data, Manifest& manifest)
+{
+    manifest.entries.clear();
+    manifest.sources.clear();
+
+    size_t offset = 0;
+
+    while (offset < data.size())
+    {
+        if (data.size() - offset < MANIFEST_ENTRY_HEADER_SIZE)
+        {
+            return false;
+        }
+
+        ManifestEntry entry;
+
+        const uint64_t type = readInteger(data.data() + offset, 1);
+        const uint64_t length = readInteger(data.data() + offset + 13, 2);
+
+        if (type > EntryType::FileEntry || data.size() - offset - MANIFEST_ENTRY_HEADER_SIZE < length)
+        {
+            return false;
+        }
+
+        entry.type = (EntryType)type;
+        entry.mode = readInteger(data.data() + offset + 1, 4);
+        entry.size = readInteger(data.data() + offset + 5, 8);
+        entry.name = data.substr(offset + MANIFEST_ENTRY_HEADER_SIZE, length);
+
+        if (!isSafe(entry.name) || (entry.type == EntryType::DirectoryEntry && entry.size != 0))
+        {
+            return false;
+        }
+
+        manifest.entries.push_back(entry);
+
+        offset += MANIFEST_ENTRY_HEADER_SIZE + length;
+    }
+
+    return !manifest.entries.empty();
+}
+
+bool Manifest::hasSingleRoot() const
+{
+    for (const ManifestEntry& entry : entries)
+    {
+        if (getRoot(entry.name) != getRoot(entries[0].name))
+        {
+            return false;
+        }
+    }
+
+    return !entries.empty();
+}
+
+std::string Manifest::getName() const
+{
+    return hasSingleRoot() ? getRoot(entries[0].name) : "Squirrel Files";
+}
+
+uint64_t Manifest::getBatchSize() const
+{
+    uint64_t size = 0;
+
+    for (const ManifestEntry& entry : entries)
+    {
+        if (entry.isBatched())
+        {
+            size += entry.size;
+        }
+    }
+
+    return size;
+}
+
+const std::vector<ManifestEntry>& Manifest::getEntries() const
+{
+    return entries;
+}
+
+std::filesystem::path Manifest::getSource(const size_t index) const
+{
+    return sources[index];
+}
+
+bool Manifest::addEntry(const std::filesystem::path source, const std::string name)
+{
+    std::error_code error;
+
+    const std::filesystem::file_status status = std::filesystem::status(source, error);
+
+    if (error || !isSafe(name))
+    {
+        return false;
+    }
+
+    ManifestEntry entry;
+
+    entry.name = name;
+    entry.type = std::filesystem::is_directory(status) ? EntryType::DirectoryEntry : EntryType::FileEntry;
+    entry.mode = (uint32_t)status.permissions() & (uint32_t)std::filesystem::perms::mask;
+    entry.size = entry.type == EntryType::FileEntry ? std::filesystem::file_size(source, error) : 0;
+
+    if (error)
+    {
+        return false;
+    }
+
+    entries.push_back(entry);
+    sources.push_back(source);
+
+    return true;
+}
+
+bool Manifest::isSafe(const std::string& name)
+{
+    if (name.empty() || name.size() > UINT16_MAX || name[0] == '/' || name.find_first_of("\\:") != std::string::npos)
+    {
+        return false;
+    }
+
+    size_t start = 0;
+
+    while (start <= name.size())
+    {
+        const size_t end = name.find('/', start) == std::string::npos ? name.size() : name.find('/', start);
+        const std::string component = name.substr(start, end - start);
+
+        if (component.empty() || component == "." || component == "..")
+        {
+            return false;
+        }
+
+        start = end + 1;
+    }
+
+    return true;
+}
+
+std::string Manifest::getRoot(const std::string& name)
+{
+    return name.substr(0, name.find('/'));
+}
+
+BatchReader::BatchReader(const Manifest& manifest) :
+    manifest(manifest) {}
+
+bool BatchReader::read(char* buffer, uint64_t size)
+{
+    const std::vector<ManifestEntry>& entries = manifest.getEntries();
+
+    while (size > 0)
+    {
+        while (entry < entries.size() && (!entries[entry].isBatched() || offset == entries[entry].size))
+        {
+            file.close();
+
+            entry++;
+            offset = 0;
+        }
+
+        if (entry == entries.size())
+        {
+            return false;
+        }
+
+        if (!file.isOpen() && !file.openRead(manifest.getSource(entry)))
+        {
+            return false;
+        }
+
+        const uint64_t count = size < entries[entry].size - offset ? size : entries[entry].size - offset;
+
+        if (!file.readAt(buffer, count, offset))
+        {
+            return false;
+        }
+
+        buffer += count;
+        size -= count;
+        offset += count;
+    }
+
+    return true;
+}
+
+BundleSink::BundleSink(const std::filesystem::path directory, const uint64_t key, const Manifest& manifest) :
+    key(key), manifest(manifest), stagingPath(directory / (".squirrel-" + std::to_string(key) + ".bundle"))
+{
+    open = restart();
+}
+
+bool BundleSink::isOpen() const
+{
+    return open;
+}
+
+bool BundleSink::isComplete() const
+{
+    uint64_t large = 0;
+
+    for (const ManifestEntry& entry : manifest.getEntries())
+    {
+        if (entry.type == EntryType::FileEntry && !entry.isBatched())
+        {
+            large++;
+        }
+    }
+
+    return entry == manifest.getEntries().size() && written == manifest.getBatchSize() && placed == large;
+}
+
+uint64_t BundleSink::getKey() const
+{
+    return key;
+}
+
+const Manifest& BundleSink::getManifest() const
+{
+    return manifest;
+}
+
+bool BundleSink::restart()
+{
+    file.close();
+
+    entry = 0;
+    offset = 0;
+    written = 0;
+    placed = 0;
+
+    std::error_code error;
+
+    std::filesystem::create_directories(stagingPath, error);
+
+    if (error)
+    {
+        return false;
+    }
+
+    for (const ManifestEntry& current : manifest.getEntries())
+    {
+        const std::filesystem::path path = stagingPath / current.name;
+
+        std::filesystem::create_directories(current.type == EntryType::DirectoryEntry ? path : path.parent_path(), error);
+
+        if (error)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BundleSink::write(const char* data, uint64_t size)
+{
+    const std::vector<ManifestEntry>& entries = manifest.getEntries();
+
+    while (true)
+    {
+        while (entry < entries.size() && (!entries[entry].isBatched() || offset == entries[entry].size))
+        {
+            if (entries[entry].isBatched() && !finishEntry())
+            {
+                return false;
+            }
+
+            entry++;
+            offset = 0;
+        }
+
+        if (size == 0)
+        {
+            return true;
+        }
+
+        if (entry == entries.size())
+        {
+            return false;
+        }
+
+        if (!file.isOpen() && !file.openWrite(stagingPath / entries[entry].name, true))
+        {
+            return false;
+        }
+
+        const uint64_t count = size < entries[entry].size - offset ? size : entries[entry].size - offset;
+
+        if (!file.writeAt(data, count, offset))
+        {
+            return false;
+        }
+
+        data += count;
+        size -= count;
+        offset += count;
+        written += count;
+    }
+}
+
+bool BundleSink::finish()
+{
+    return write(nullptr, 0) && entry == manifest.getEntries().size() && written == manifest.getBatchSize();
+}
+
+bool BundleSink::place(ReceiveResult* sink, const size_t index)
+{
+    const ManifestEntry& current = manifest.getEntries()[index];
+
+    const std::filesystem::path path = stagingPath / current.name;
+
+    if (!sink->commit(path))
+    {
+        return false;
+    }
+
+    std::error_code error;
+
+    std::filesystem::permissions(path, (std::filesystem::perms)current.mode, error);
+
+    placed++;
+
+    return true;
+}
+
+std::string BundleSink::getName() const
+{
+    return manifest.getName();
+}
+
+bool BundleSink::commit(const std::filesystem::path path)
+{
+    const std::vector<ManifestEntry>& entries = manifest.getEntries();
+
+    std::error_code error;
+
+    for (size_t i = entries.size(); i > 0; i--)
+    {
+        if (entries[i - 1].type == EntryType::DirectoryEntry)
+        {
+            std::filesystem::permissions(stagingPath / entries[i - 1].name, (std::filesystem::perms)entries[i - 1].mode, error);
+        }
+    }
+
+    const std::filesystem::path source = manifest.hasSingleRoot() ? stagingPath / manifest.getName() : stagingPath;
+
+    std::filesystem::rename(source, path, error);
+
+    if (error)
+    {
+        error.clear();
+
+        std::filesystem::copy(source, path, std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing, error);
+    }
+
+    if (error)
+    {
+        return false;
+    }
+
+    std::filesystem::remove_all(stagingPath, error);
+
+    return true;
+}
+
+void BundleSink::discard()
+{
+    file.close();
+
+    std::error_code error;
+
+    std::filesystem::remove_all(stagingPath, error);
+}
+
+bool BundleSink::finishEntry()
+{
+    const ManifestEntry& current = manifest.getEntries()[entry];
+
+    const std::filesystem::path path = stagingPath / current.name;
+
+    if (!file.isOpen() && !file.openWrite(path, true))
+    {
+        return false;
+    }
+
+    if (!file.close())
+    {
+        return false;
+    }
+
+    std::error_code error;
+
+    std::filesystem::permissions(path, (std::filesystem::perms)current.mode, error);
+
+    return true;
+}
@@ -0,0 +1,306 @@
+#include "../include/compress.h"
+
+static uint32_t readWord(const unsigned char* data)
+{
+    uint32_t value;
+
+    memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+static uint32_t hashWord(const uint32_t word)
+{
+    return (word * 2654435761u) >> (32 - LZ4_HASH_BITS);
+}
+
+static bool writeLength(unsigned char*& output, const unsigned char* end, uint64_t length)
+{
+    while (length >= 255)
+    {
+        if (output >= end)
+        {
+            return false;
+        }
+
+        *output++ = 255;
+
+        length -= 255;
+    }
+
+    if (output >= end)
+    {
+        return false;
+    }
+
+    *output++ = length;
+
+    return true;
+}
+
+static bool writeSequence(unsigned char*& output, const unsigned char* end, const unsigned char* literals, const uint64_t literalLength, const uint64_t offset, const uint64_t matchLength)
+{
+    if (output >= end)
+    {
+        return false;
+    }
+
+    unsigned char* token = output++;
+
+    *token = (literalLength < 15 ? literalLength : 15) << 4;
+
+    if (literalLength >= 15 && !writeLength(output, end, literalLength - 15))
+    {
+        return false;
+    }
+
+    if ((uint64_t)(end - output) < literalLength)
+    {
+        return false;
+    }
+
+    memcpy(output, literals, literalLength);
+
+    output += literalLength;
+
+    if (matchLength == 0)
+    {
+        return true;
+    }
+
+    if (end - output < 2)
+    {
+        return false;
+    }
+
+    *output++ = offset & 0xff;
+    *output++ = offset >> 8;
+
+    const uint64_t length = matchLength - LZ4_MIN_MATCH;
+
+    *token |= length < 15 ? length : 15;
+
+    return length < 15 || writeLength(output, end, length - 15);
+}
+
+static bool readLength(const unsigned char*& input, const unsigned char* end, uint64_t& length)
+{
+    unsigned char byte = 255;
+
+    while (byte == 255)
+    {
+        if (input >= end)
+        {
+            return false;
+        }
+
+        byte = *input++;
+
+        length += byte;
+    }
+
+    return true;
+}
+
+Compressor::Compressor() :
+    table(1 << LZ4_HASH_BITS) {}
+
+uint64_t Compressor::bound(const uint64_t size)
+{
+    return size + size / 255 + 16;
+}
+
+double Compressor::estimateEntropy(const char* data, const uint64_t size)
+{
+    uint64_t counts[256] = {};
+    uint64_t total = 0;
+
+    if (size <= COMPRESSION_SAMPLES * COMPRESSION_SAMPLE_SIZE)
+    {
+        for (uint64_t i = 0; i < size; i++)
+        {
+            counts[(unsigned char)data[i]]++;
+        }
+
+        total = size;
+    }
+
+    else
+    {
+        const uint64_t stride = size / COMPRESSION_SAMPLES;
+
+        for (uint64_t sample = 0; sample < COMPRESSION_SAMPLES; sample++)
+        {
+            for (uint64_t i = 0; i < COMPRESSION_SAMPLE_SIZE; i++)
+            {
+                counts[(unsigned char)data[sample * stride + i]]++;
+            }
+        }
+
+        total = COMPRESSION_SAMPLES * COMPRESSION_SAMPLE_SIZE;
+    }
+
+    double entropy = 0;
+
+    for (const uint64_t count : counts)
+    {
+        if (count > 0)
+        {
+            const double probability = (double)count / total;
+
+            entropy -= probability * std::log2(probability);
+        }
+    }
+
+    return entropy;
+}
+
+uint64_t Compressor::compress(const char* data, const uint64_t size, char* output, const uint64_t capacity)
+{
+    const unsigned char* input = (const unsigned char*)data;
+
+    unsigned char* out = (unsigned char*)output;
+    const unsigned char* outEnd = out + capacity;
+
+    uint64_t anchor = 0;
+
+    if (size > LZ4_MATCH_LIMIT)
+    {
+        std::fill(table.begin(), table.end(), 0);
+
+        const uint64_t matchStartLimit = size - LZ4_MATCH_LIMIT;
+        const uint64_t matchEndLimit = size - LZ4_LAST_LITERALS;
+
+        uint64_t position = 0;
+
+        while (position < matchStartLimit)
+        {
+            const uint32_t word = readWord(input + position);
+            const uint32_t hash = hashWord(word);
+            const uint64_t candidate = table[hash];
+
+            table[hash] = position;
+
+            if (candidate >= position || position - candidate > LZ4_MAX_OFFSET || readWord(input + candidate) != word)
+            {
+                position += 1 + ((position - anchor) >> 6);
+
+                continue;
+            }
+
+            uint64_t length = LZ4_MIN_MATCH;
+
+            while (position + length < matchEndLimit && input[candidate + length] == input[position + length])
+            {
+                length++;
+            }
+
+            if (!writeSequence(out, outEnd, input + anchor, position - anchor, position - candidate, length))
+            {
+                return 0;
+            }
+
+            position += length;
+            anchor = position;
+        }
+    }
+
+    if (!writeSequence(out, outEnd, input + anchor, size - anchor, 0, 0))
+    {
+        return 0;
+    }
+
+    return out - (unsigned char*)output;
+}
+
+uint64_t Compressor::compressChunk(const char* data, const uint64_t size, char* output, const uint64_t capacity)
+{
+    if (estimateEntropy(data, size) > COMPRESSION_ENTROPY_LIMIT)
+    {
+        return 0;
+    }
+
+    const uint64_t limit = size - size / 16;
+
+    const uint64_t compressed = compress(data, size, output, capacity < limit ? capacity : limit);
+
+    return compressed < limit ? compressed : 0;
+}
+
+bool Compressor::decompress(const char* data, const uint64_t size, char* output, const uint64_t expected)
+{
+    const unsigned char* input = (const unsigned char*)data;
+    const unsigned char* inputEnd = input + size;
+
+    unsigned char* out = (unsigned char*)output;
+    unsigned char* outEnd = out + expected;
+
+    while (input < inputEnd)
+    {
+        const unsigned char token = *input++;
+
+        uint64_t literalLength = token >> 4;
+
+        if (literalLength == 15 && !readLength(input, inputEnd, literalLength))
+        {
+            return false;
+        }
+
+        if ((uint64_t)(inputEnd - input) < literalLength || (uint64_t)(outEnd - out) < literalLength)
+        {
+            return false;
+        }
+
+        memcpy(out, input, literalLength);
+
+        input += literalLength;
+        out += literalLength;
+
+        if (input == inputEnd)
+        {
+            break;
+        }
+
+        if (inputEnd - input < 2)
+        {
+            return false;
+        }
+
+        const uint64_t offset = input[0] | (input[1] << 8);
+
+        input += 2;
+
+        uint64_t matchLength = token & 15;
+
+        if (matchLength == 15 && !readLength(input, inputEnd, matchLength))
+        {
+            return false;
+        }
+
+        matchLength += LZ4_MIN_MATCH;
+
+        if (offset == 0 || offset > (uint64_t)(out - (unsigned char*)output) || (uint64_t)(outEnd - out) < matchLength)
+        {
+            return false;
+        }
+
+        const unsigned char* match = out - offset;
+
+        if (offset >= matchLength)
+        {
+            memcpy(out, match, matchLength);
+
+            out += matchLength;
+        }
+
+        else
+        {
+            for (uint64_t i = 0; i < matchLength; i++)
+            {
+                *out++ = *match++;
+            }
+        }
+    }
+
+    return out == outEnd;
+}
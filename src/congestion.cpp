@@ -0,0 +1,148 @@
+#include "../include/congestion.h"
+
+RateController::RateController() :
+    samples(1, RATE_INITIAL), roundStart(std::chrono::steady_clock::now()) {}
+
+void RateController::acknowledged(const uint64_t bytes, const double roundTrip)
+{
+    backoff = 0;
+
+    if (roundTrip > 0)
+    {
+        if (smoothedTrip == 0)
+        {
+            smoothedTrip = roundTrip;
+            tripVariance = roundTrip / 2;
+        }
+
+        else
+        {
+            tripVariance = tripVariance * 0.75 + std::abs(smoothedTrip - roundTrip) * 0.25;
+            smoothedTrip = smoothedTrip * 0.875 + roundTrip * 0.125;
+        }
+
+        minTrip = minTrip == 0 ? roundTrip : std::min(minTrip, roundTrip);
+    }
+
+    roundDelivered += bytes;
+
+    const std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+
+    if (std::chrono::duration<double>(now - roundStart).count() >= std::max(smoothedTrip, RATE_MIN_ROUND / 1000.0))
+    {
+        finishRound(now);
+    }
+}
+
+void RateController::lost(const uint64_t bytes)
+{
+    roundLost += bytes;
+}
+
+void RateController::timedOut()
+{
+    backoff = std::min(backoff + 1, 6u);
+
+    bandwidth = std::max(bandwidth / 2, (double)RATE_MINIMUM);
+
+    samples.assign(1, bandwidth);
+
+    phase = RatePhase::RateProbe;
+    cycle = 2;
+}
+
+void RateController::blocked()
+{
+    roundBlocked = true;
+}
+
+double RateController::getRate() const
+{
+    return std::max(bandwidth * getGain(), (double)RATE_MINIMUM);
+}
+
+uint64_t RateController::getWindow() const
+{
+    return std::max((uint64_t)(2 * bandwidth * std::max(getGain(), 1.0) * minTrip), (uint64_t)RATE_MIN_WINDOW);
+}
+
+std::chrono::microseconds RateController::getTimeout() const
+{
+    const double timeout = smoothedTrip > 0 ? std::min(smoothedTrip * 1000 + std::max(4 * tripVariance * 1000, (double)RATE_MIN_TIMEOUT), (double)RATE_MAX_TIMEOUT) : RATE_INITIAL_TIMEOUT;
+
+    return std::chrono::microseconds((uint64_t)(std::min(timeout * (1 << backoff), (double)RATE_MAX_TIMEOUT) * 1000));
+}
+
+void RateController::finishRound(const std::chrono::time_point<std::chrono::steady_clock> now)
+{
+    const double sample = roundDelivered / std::chrono::duration<double>(now - roundStart).count();
+    const double loss = roundDelivered + roundLost > 0 ? (double)roundLost / (roundDelivered + roundLost) : 0;
+
+    if (roundBlocked || sample > bandwidth)
+    {
+        samples.push_back(sample);
+
+        if (samples.size() > RATE_FILTER_ROUNDS)
+        {
+            samples.pop_front();
+        }
+
+        bandwidth = std::max(*std::max_element(samples.begin(), samples.end()), (double)RATE_MINIMUM);
+    }
+
+    if (loss > RATE_LOSS_THRESHOLD)
+    {
+        bandwidth = std::max(bandwidth * RATE_LOSS_BACKOFF, (double)RATE_MINIMUM);
+
+        samples.assign(1, bandwidth);
+
+        phase = RatePhase::RateProbe;
+        cycle = 2;
+    }
+
+    else if (phase == RatePhase::RateStartup && roundBlocked)
+    {
+        if (bandwidth >= fullBandwidth * 1.25)
+        {
+            fullBandwidth = bandwidth;
+
+            stalledRounds = 0;
+        }
+
+        else if (++stalledRounds >= RATE_STARTUP_ROUNDS)
+        {
+            phase = RatePhase::RateProbe;
+            cycle = 1;
+        }
+    }
+
+    else if (phase == RatePhase::RateProbe)
+    {
+        cycle = (cycle + 1) % RATE_PROBE_CYCLE;
+    }
+
+    roundDelivered = 0;
+    roundLost = 0;
+    roundBlocked = false;
+    roundStart = now;
+}
+
+double RateController::getGain() const
+{
+    if (phase == RatePhase::RateStartup)
+    {
+        return RATE_STARTUP_GAIN;
+    }
+
+    if (cycle == 0)
+    {
+        return RATE_PROBE_GAIN;
+    }
+
+    if (cycle == 1)
+    {
+        return RATE_DRAIN_GAIN;
+    }
+
+    return 1;
+}
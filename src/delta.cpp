@@ -0,0 +1,362 @@
+#include "../include/delta.h"
+
+void RollingChecksum::reset(const char* data, const size_t size)
+{
+    a = 0;
+    b = 0;
+
+    this->size = size;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        a += (unsigned char)data[i];
+        b += (size - i) * (unsigned char)data[i];
+    }
+
+    a &= 0xffff;
+    b &= 0xffff;
+}
+
+void RollingChecksum::roll(const char out, const char in)
+{
+    a = (a - (unsigned char)out + (unsigned char)in) & 0xffff;
+    b = (b - size * (unsigned char)out + a) & 0xffff;
+}
+
+uint32_t RollingChecksum::value() const
+{
+    return a | (b << 16);
+}
+
+uint32_t Signature::chooseBlockSize(const uint64_t size)
+{
+    uint64_t blockSize = (uint64_t)std::sqrt((double)size);
+
+    if (blockSize < DELTA_MIN_BLOCK)
+    {
+        blockSize = DELTA_MIN_BLOCK;
+    }
+
+    if (blockSize > DELTA_MAX_BLOCK)
+    {
+        blockSize = DELTA_MAX_BLOCK;
+    }
+
+    if (size / blockSize > DELTA_MAX_BLOCKS)
+    {
+        blockSize = size / DELTA_MAX_BLOCKS + 1;
+    }
+
+    return blockSize;
+}
+
+bool Signature::compute(const File& file, const uint64_t size)
+{
+    blockSize = chooseBlockSize(size);
+
+    blocks.clear();
+    blocks.reserve(size / blockSize);
+
+    std::vector<char> buffer(CHUNK_SIZE / blockSize > 0 ? CHUNK_SIZE / blockSize * blockSize : blockSize);
+
+    RollingChecksum checksum;
+
+    for (uint64_t offset = 0; offset + blockSize <= size;)
+    {
+        const uint64_t count = (size - offset) / blockSize < buffer.size() / blockSize ? (size - offset) / blockSize : buffer.size() / blockSize;
+
+        if (!file.readAt(buffer.data(), count * blockSize, offset))
+        {
+            return false;
+        }
+
+        for (uint64_t i = 0; i < count; i++)
+        {
+            const char* data = buffer.data() + i * blockSize;
+
+            BlockSignature block;
+
+            checksum.reset(data, blockSize);
+
+            block.weak = checksum.value();
+
+            memcpy(block.strong, Sha256::digest(data, blockSize).data(), DELTA_STRONG_SIZE);
+
+            blocks.push_back(block);
+        }
+
+        offset += count * blockSize;
+    }
+
+    return true;
+}
+
+std::string Signature::encode() const
+{
+    std::string data(blocks.size() * DELTA_SIGNATURE_SIZE, '\0');
+
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        char* record = data.data() + i * DELTA_SIGNATURE_SIZE;
+
+        for (unsigned int j = 0; j < 4; j++)
+        {
+            record[j] = (blocks[i].weak >> (j * 8)) & 0xff;
+        }
+
+        memcpy(record + 4, blocks[i].strong, DELTA_STRONG_SIZE);
+    }
+
+    return data;
+}
+
+bool Signature::decode(const std::string& data, const uint32_t blockSize)
+{
+    if (blockSize < DELTA_MIN_BLOCK || blockSize > CHUNK_SIZE || data.size() % DELTA_SIGNATURE_SIZE != 0 || data.size() / DELTA_SIGNATURE_SIZE > DELTA_MAX_BLOCKS)
+    {
+        return false;
+    }
+
+    this->blockSize = blockSize;
+
+    blocks.resize(data.size() / DELTA_SIGNATURE_SIZE);
+
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        const char* record = data.data() + i * DELTA_SIGNATURE_SIZE;
+
+        blocks[i].weak = 0;
+
+        for (unsigned int j = 0; j < 4; j++)
+        {
+            blocks[i].weak |= (uint32_t)(unsigned char)record[j] << (j * 8);
+        }
+
+        memcpy(blocks[i].strong, record + 4, DELTA_STRONG_SIZE);
+    }
+
+    return true;
+}
+
+uint32_t Signature::getBlockSize() const
+{
+    return blockSize;
+}
+
+const std::vector<BlockSignature>& Signature::getBlocks() const
+{
+    return blocks;
+}
+
+DeltaEncoder::DeltaEncoder(const Signature& signature) :
+    signature(signature), filter(1 << 16)
+{
+    const std::vector<BlockSignature>& blocks = signature.getBlocks();
+
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        index[blocks[i].weak].push_back(i);
+
+        filter[filterIndex(blocks[i].weak)] = true;
+    }
+}
+
+bool DeltaEncoder::encode(const File& file, const uint64_t size,
+    const std::function<bool(const uint64_t, const char*, const uint64_t)> emitLiteral,
+    const std::function<bool(const uint64_t, const uint64_t, const uint64_t)> emitCopy) const
+{
+    const uint64_t blockSize = signature.getBlockSize();
+
+    std::vector<char> buffer(CHUNK_SIZE * 2 + blockSize);
+
+    uint64_t bufferStart = 0;
+    uint64_t bufferEnd = 0;
+
+    uint64_t position = 0;
+    uint64_t literalStart = 0;
+
+    uint64_t copyOffset = 0;
+    uint64_t copyBlock = 0;
+    uint64_t copyCount = 0;
+
+    const std::function<bool(const uint64_t)> fill = [&](const uint64_t end)
+    {
+        if (end <= bufferEnd)
+        {
+            return true;
+        }
+
+        memmove(buffer.data(), buffer.data() + (literalStart - bufferStart), bufferEnd - literalStart);
+
+        bufferStart = literalStart;
+
+        const uint64_t space = buffer.size() - (bufferEnd - bufferStart);
+        const uint64_t count = size - bufferEnd < space ? size - bufferEnd : space;
+
+        if (!file.readAt(buffer.data() + (bufferEnd - bufferStart), count, bufferEnd))
+        {
+            return false;
+        }
+
+        bufferEnd += count;
+
+        return end <= bufferEnd;
+    };
+
+    const std::function<bool()> flushCopy = [&]()
+    {
+        if (copyCount == 0)
+        {
+            return true;
+        }
+
+        const bool emitted = emitCopy(copyOffset, copyBlock, copyCount);
+
+        copyCount = 0;
+
+        return emitted;
+    };
+
+    const std::function<bool(const uint64_t)> flushLiteral = [&](const uint64_t end)
+    {
+        if (end == literalStart)
+        {
+            return true;
+        }
+
+        if (!flushCopy() || !emitLiteral(literalStart, buffer.data() + (literalStart - bufferStart), end - literalStart))
+        {
+            return false;
+        }
+
+        literalStart = end;
+
+        return true;
+    };
+
+    RollingChecksum checksum;
+
+    bool rolling = false;
+
+    while (position + blockSize <= size)
+    {
+        if (position + blockSize > bufferEnd && !fill(position + blockSize))
+        {
+            return false;
+        }
+
+        const char* window = buffer.data() + (position - bufferStart);
+
+        if (!rolling)
+        {
+            checksum.reset(window, blockSize);
+
+            rolling = true;
+        }
+
+        const int64_t match = find(checksum.value(), window, copyCount > 0 ? copyBlock + copyCount : UINT64_MAX);
+
+        if (match >= 0)
+        {
+            if (!flushLiteral(position))
+            {
+                return false;
+            }
+
+            if (copyCount > 0 && (uint64_t)match == copyBlock + copyCount)
+            {
+                copyCount++;
+            }
+            else
+            {
+                if (!flushCopy())
+                {
+                    return false;
+                }
+
+                copyOffset = position;
+                copyBlock = match;
+                copyCount = 1;
+            }
+
+            position += blockSize;
+            literalStart = position;
+
+            rolling = false;
+
+            continue;
+        }
+
+        const char out = window[0];
+
+        position++;
+
+        if (position - literalStart >= CHUNK_SIZE && !flushLiteral(position))
+        {
+            return false;
+        }
+
+        if (position + blockSize > size)
+        {
+            break;
+        }
+
+        if (position + blockSize > bufferEnd && !fill(position + blockSize))
+        {
+            return false;
+        }
+
+        checksum.roll(out, buffer[position + blockSize - 1 - bufferStart]);
+    }
+
+    while (literalStart < size)
+    {
+        const uint64_t end = size - literalStart < CHUNK_SIZE ? size : literalStart + CHUNK_SIZE;
+
+        if (!fill(end) || !flushLiteral(end))
+        {
+            return false;
+        }
+    }
+
+    return flushCopy();
+}
+
+int64_t DeltaEncoder::find(const uint32_t weak, const char* data, const uint64_t expected) const
+{
+    if (!filter[filterIndex(weak)])
+    {
+        return -1;
+    }
+
+    const std::unordered_map<uint32_t, std::vector<uint32_t>>::const_iterator candidates = index.find(weak);
+
+    if (candidates == index.end())
+    {
+        return -1;
+    }
+
+    const std::string strong = Sha256::digest(data, signature.getBlockSize());
+
+    const std::vector<BlockSignature>& blocks = signature.getBlocks();
+
+    if (expected < blocks.size() && blocks[expected].weak == weak && memcmp(blocks[expected].strong, strong.data(), DELTA_STRONG_SIZE) == 0)
+    {
+        return expected;
+    }
+
+    for (const uint32_t candidate : candidates->second)
+    {
+        if (memcmp(blocks[candidate].strong, strong.data(), DELTA_STRONG_SIZE) == 0)
+        {
+            return candidate;
+        }
+    }
+
+    return -1;
+}
+
+uint32_t DeltaEncoder::filterIndex(const uint32_t weak)
+{
+    return (weak ^ (weak >> 16)) & 0xffff;
+}
@@ -70,6 +70,27 @@ std::filesystem::path WinFileManager::getResourcePath(const std::string name) co
     return std::filesystem::path("resources") / name;
 }
 
+std::filesystem::path WinFileManager::getReceivePath() const
+{
+    char* profile = nullptr;
+
+    size_t length = 0;
+
+    if (_dupenv_s(&profile, &length, "USERPROFILE") == 0 && profile)
+    {
+        const std::filesystem::path downloads = std::filesystem::path(profile) / "Downloads";
+
+        free(profile);
+
+        if (std::filesystem::is_directory(downloads))
+        {
+            return downloads;
+        }
+    }
+
+    return std::filesystem::temp_directory_path();
+}
+
 #elif __linux__
 
 std::filesystem::path LinuxFileManager::getSavePath(const std::string name) const
@@ -107,4 +128,21 @@ std::filesystem::path LinuxFileManager::getResourcePath(const std::string name)
     #endif
 }
 
+std::filesystem::path LinuxFileManager::getReceivePath() const
+{
+    if (const char* home = getenv("HOME"))
+    {
+        const std::filesystem::path downloads = std::filesystem::path(home) / "Downloads";
+
+        if (std::filesystem::is_directory(downloads))
+        {
+            return downloads;
+        }
+
+        return home;
+    }
+
+    return std::filesystem::temp_directory_path();
+}
+
 #endif
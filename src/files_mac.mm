@@ -1,6 +1,7 @@
 #include "../include/files.h"
 
 #import <AppKit/NSSavePanel.h>
+#import <Foundation/NSFileManager.h>
 #import <Foundation/NSString.h>
 #import <Foundation/NSURL.h>
 
@@ -65,3 +66,15 @@ std::filesystem::path MacFileManager::getResourcePath(const std::string name) co
 
     return std::filesystem::path("resources") / name;
 }
+
+std::filesystem::path MacFileManager::getReceivePath() const
+{
+    NSURL* downloads = [ [ NSFileManager defaultManager ] URLForDirectory: NSDownloadsDirectory inDomain: NSUserDomainMask appropriateForURL: nil create: NO error: nil ];
+
+    if (downloads)
+    {
+        return std::string([ downloads fileSystemRepresentation ]);
+    }
+
+    return std::filesystem::temp_directory_path();
+}
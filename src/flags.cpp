@@ -22,6 +22,13 @@ Flags* Flags::parse(const int argc, char** argv, ErrorHandler* errorHandler)
                 return nullptr;
             }
 
+            if (flags->type == LaunchType::Benchmark)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--service\" is not compatible with argument \"--benchmark\"."));
+
+                return nullptr;
+            }
+
             flags->type = LaunchType::Service;
         }
 
@@ -41,9 +48,230 @@ Flags* Flags::parse(const int argc, char** argv, ErrorHandler* errorHandler)
                 return nullptr;
             }
 
+            if (flags->type == LaunchType::Benchmark)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--receive\" is not compatible with argument \"--benchmark\"."));
+
+                return nullptr;
+            }
+
             flags->type = LaunchType::Receive;
         }
 
+        else if (strncmp(argv[i], "--benchmark", 11) == 0)
+        {
+            if (flags->type == LaunchType::Benchmark)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--benchmark\" specified more than once."));
+
+                return nullptr;
+            }
+
+            if (flags->type != LaunchType::General)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--benchmark\" is not compatible with other launch types."));
+
+                return nullptr;
+            }
+
+            flags->type = LaunchType::Benchmark;
+        }
+
+        else if (strncmp(argv[i], "--streams", 9) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--streams\" expects a stream count."));
+
+                return nullptr;
+            }
+
+            const std::string count = argv[++i];
+
+            if (count.empty() || count.size() > 2 || count.find_first_not_of("0123456789") != std::string::npos || std::stoul(count) > MAX_STREAMS)
+            {
+                errorHandler->handle(SquirrelArgumentException("Stream count must be between 0 and " + std::to_string(MAX_STREAMS) + "."));
+
+                return nullptr;
+            }
+
+            flags->streams = std::stoul(count);
+        }
+
+        else if (strncmp(argv[i], "--concurrency", 13) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--concurrency\" expects a transfer count."));
+
+                return nullptr;
+            }
+
+            const std::string count = argv[++i];
+
+            if (count.empty() || count.size() > 2 || count.find_first_not_of("0123456789") != std::string::npos || std::stoul(count) == 0 || std::stoul(count) > MAX_CONCURRENCY)
+            {
+                errorHandler->handle(SquirrelArgumentException("Transfer count must be between 1 and " + std::to_string(MAX_CONCURRENCY) + "."));
+
+                return nullptr;
+            }
+
+            flags->concurrency = std::stoul(count);
+        }
+
+        else if (strncmp(argv[i], "--bandwidth", 11) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--bandwidth\" expects a limit in megabytes per second."));
+
+                return nullptr;
+            }
+
+            const std::string limit = argv[++i];
+
+            if (limit.empty() || limit.size() > 6 || limit.find_first_not_of("0123456789") != std::string::npos)
+            {
+                errorHandler->handle(SquirrelArgumentException("Bandwidth limit must be a whole number of megabytes per second."));
+
+                return nullptr;
+            }
+
+            flags->bandwidth = std::stoull(limit) * 1048576;
+        }
+
+        else if (strncmp(argv[i], "--peer-bandwidth", 16) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--peer-bandwidth\" expects a limit in megabytes per second."));
+
+                return nullptr;
+            }
+
+            const std::string limit = argv[++i];
+
+            if (limit.empty() || limit.size() > 6 || limit.find_first_not_of("0123456789") != std::string::npos)
+            {
+                errorHandler->handle(SquirrelArgumentException("Bandwidth limit must be a whole number of megabytes per second."));
+
+                return nullptr;
+            }
+
+            flags->peerBandwidth = std::stoull(limit) * 1048576;
+        }
+
+        else if (strncmp(argv[i], "--transfer-bandwidth", 20) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--transfer-bandwidth\" expects a limit in megabytes per second."));
+
+                return nullptr;
+            }
+
+            const std::string limit = argv[++i];
+
+            if (limit.empty() || limit.size() > 6 || limit.find_first_not_of("0123456789") != std::string::npos)
+            {
+                errorHandler->handle(SquirrelArgumentException("Bandwidth limit must be a whole number of megabytes per second."));
+
+                return nullptr;
+            }
+
+            flags->transferBandwidth = std::stoull(limit) * 1048576;
+        }
+
+        else if (strncmp(argv[i], "--dedup", 7) == 0)
+        {
+            if (flags->dedup)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--dedup\" specified more than once."));
+
+                return nullptr;
+            }
+
+            flags->dedup = true;
+        }
+
+        else if (strncmp(argv[i], "--compress", 10) == 0)
+        {
+            if (flags->compress)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--compress\" specified more than once."));
+
+                return nullptr;
+            }
+
+            flags->compress = true;
+        }
+
+        else if (strncmp(argv[i], "--io-uring", 10) == 0)
+        {
+            if (flags->ioUring)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--io-uring\" specified more than once."));
+
+                return nullptr;
+            }
+
+            flags->ioUring = true;
+        }
+
+        else if (strncmp(argv[i], "--udp", 5) == 0)
+        {
+            if (flags->udp)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--udp\" specified more than once."));
+
+                return nullptr;
+            }
+
+            flags->udp = true;
+        }
+
+        else if (strncmp(argv[i], "--loss", 6) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--loss\" expects a percentage."));
+
+                return nullptr;
+            }
+
+            const std::string percent = argv[++i];
+
+            if (percent.empty() || percent.size() > 2 || percent.find_first_not_of("0123456789") != std::string::npos)
+            {
+                errorHandler->handle(SquirrelArgumentException("Loss must be a whole percentage between 0 and 99."));
+
+                return nullptr;
+            }
+
+            flags->loss = std::stoul(percent);
+        }
+
+        else if (strncmp(argv[i], "--latency", 9) == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                errorHandler->handle(SquirrelArgumentException("Argument \"--latency\" expects a delay in milliseconds."));
+
+                return nullptr;
+            }
+
+            const std::string delay = argv[++i];
+
+            if (delay.empty() || delay.size() > 5 || delay.find_first_not_of("0123456789") != std::string::npos || std::stoul(delay) > DATAGRAM_MAX_LATENCY)
+            {
+                errorHandler->handle(SquirrelArgumentException("Latency must be between 0 and " + std::to_string(DATAGRAM_MAX_LATENCY) + " milliseconds."));
+
+                return nullptr;
+            }
+
+            flags->latency = std::stoul(delay);
+        }
+
         else if (strncmp(argv[i], "--", 2) == 0)
         {
             errorHandler->handle(SquirrelArgumentException("Unknown argument \"" + std::string(argv[i]) + "\"."));
@@ -60,34 +288,45 @@ Flags* Flags::parse(const int argc, char** argv, ErrorHandler* errorHandler)
                 return nullptr;
             }
 
-            if (flags->type == LaunchType::Receive)
+            if (flags->type == LaunchType::Receive && flags->ip.empty())
             {
                 flags->ip = argv[i];
             }
 
             else
             {
-                if (flags->path == "")
+                if (!std::filesystem::exists(argv[i]))
                 {
-                    flags->path = argv[i];
-
-                    if (!std::filesystem::exists(flags->path))
-                    {
-                        errorHandler->handle(SquirrelArgumentException("Specified file \"" + flags->path + "\" does not exist."));
-
-                        return nullptr;
-                    }
-                }
-
-                else
-                {
-                    errorHandler->handle(SquirrelArgumentException("Too many file arguments specified."));
+                    errorHandler->handle(SquirrelArgumentException("Specified file \"" + std::string(argv[i]) + "\" does not exist."));
 
                     return nullptr;
                 }
+
+                flags->paths.push_back(argv[i]);
             }
         }
     }
 
+    if ((flags->loss > 0 || flags->latency > 0) && !flags->udp)
+    {
+        errorHandler->handle(SquirrelArgumentException("Arguments \"--loss\" and \"--latency\" only apply with argument \"--udp\"."));
+
+        return nullptr;
+    }
+
+    if (flags->type == LaunchType::Receive && flags->paths.size() > 1)
+    {
+        errorHandler->handle(SquirrelArgumentException("Launch type \"--receive\" expects at most one file argument."));
+
+        return nullptr;
+    }
+
+    if (flags->type == LaunchType::Benchmark && flags->paths.size() > 1)
+    {
+        errorHandler->handle(SquirrelArgumentException("Launch type \"--benchmark\" expects at most one file argument."));
+
+        return nullptr;
+    }
+
     return flags;
 }
@@ -0,0 +1,300 @@
+#include "../include/frame.h"
+
+static void writeInteger(char* buffer, const uint64_t value, const unsigned int size)
+{
+    for (unsigned int i = 0; i < size; i++)
+    {
+        buffer[i] = (value >> (i * 8)) & 0xff;
+    }
+}
+
+static uint64_t readInteger(const char* buffer, const unsigned int size)
+{
+    uint64_t value = 0;
+
+    for (unsigned int i = 0; i < size; i++)
+    {
+        value |= (uint64_t)(unsigned char)buffer[i] << (i * 8);
+    }
+
+    return value;
+}
+
+FrameHeader::FrameHeader() {}
+
+FrameHeader::FrameHeader(const FrameType type, const uint16_t flags, const uint32_t messageLength, const uint64_t payloadLength) :
+    type(type), flags(flags), messageLength(messageLength), payloadLength(payloadLength) {}
+
+void FrameHeader::encode(char* buffer) const
+{
+    memcpy(buffer, FRAME_MAGIC, 4);
+
+    writeInteger(buffer + 4, version, 1);
+    writeInteger(buffer + 5, type, 1);
+    writeInteger(buffer + 6, flags, 2);
+    writeInteger(buffer + 8, messageLength, 4);
+    writeInteger(buffer + 12, payloadLength, 8);
+}
+
+bool FrameHeader::decode(const char* buffer, FrameHeader& header)
+{
+    if (memcmp(buffer, FRAME_MAGIC, 4) != 0)
+    {
+        return false;
+    }
+
+    header.version = readInteger(buffer + 4, 1);
+
+    if (header.version != FRAME_VERSION)
+    {
+        return false;
+    }
+
+    const uint8_t type = readInteger(buffer + 5, 1);
+
+    if (type != FrameType::Control && type != FrameType::Data)
+    {
+        return false;
+    }
+
+    header.type = (FrameType)type;
+    header.flags = readInteger(buffer + 6, 2);
+    header.messageLength = readInteger(buffer + 8, 4);
+    header.payloadLength = readInteger(buffer + 12, 8);
+
+    return header.type == FrameType::Data || header.payloadLength == 0;
+}
+
+FrameDecoder::FrameDecoder() {}
+
+void FrameDecoder::setLimit(const FrameType type, const uint32_t messageLimit, const uint64_t payloadLimit)
+{
+    messageLimits[type] = messageLimit;
+    payloadLimits[type] = payloadLimit;
+}
+
+bool FrameDecoder::feed(const char* data, const uint64_t size)
+{
+    if (!valid)
+    {
+        return false;
+    }
+
+    // Views handed out by next() stay valid until more data arrives.
+
+    buffer.erase(0, position);
+    buffer.append(data, size);
+
+    position = 0;
+
+    advance();
+
+    return valid;
+}
+
+bool FrameDecoder::next(FrameHeader& frame, std::string_view& message, std::string_view& payload)
+{
+    if (!advance())
+    {
+        return false;
+    }
+
+    const char* body = buffer.data() + position + FRAME_HEADER_SIZE;
+
+    frame = header;
+    message = std::string_view(body, header.messageLength);
+    payload = std::string_view(body + header.messageLength, header.payloadLength);
+
+    position += FRAME_HEADER_SIZE + header.messageLength + header.payloadLength;
+
+    state = FrameDecoderState::DecodingHeader;
+
+    return true;
+}
+
+bool FrameDecoder::isValid() const
+{
+    return valid;
+}
+
+bool FrameDecoder::advance()
+{
+    if (!valid)
+    {
+        return false;
+    }
+
+    if (state == FrameDecoderState::DecodingHeader)
+    {
+        if (buffer.size() - position < FRAME_HEADER_SIZE)
+        {
+            return false;
+        }
+
+        if (!FrameHeader::decode(buffer.data() + position, header) || header.messageLength > messageLimits[header.type] || header.payloadLength > payloadLimits[header.type])
+        {
+            valid = false;
+
+            return false;
+        }
+
+        state = FrameDecoderState::DecodingBody;
+    }
+
+    return buffer.size() - position - FRAME_HEADER_SIZE >= header.messageLength + header.payloadLength;
+}
+
+StreamHeader::StreamHeader() {}
+
+StreamHeader::StreamHeader(const StreamFrameType type, const uint32_t stream, const uint32_t length) :
+    type(type), stream(stream), length(length) {}
+
+void StreamHeader::encode(char* buffer) const
+{
+    writeInteger(buffer, type, 1);
+    writeInteger(buffer + 1, stream, 4);
+    writeInteger(buffer + 5, length, 4);
+}
+
+bool StreamHeader::decode(const char* buffer, StreamHeader& header)
+{
+    const uint8_t type = readInteger(buffer, 1);
+
+    if (type != StreamFrameType::StreamData && type != StreamFrameType::StreamWindow && type != StreamFrameType::StreamClose)
+    {
+        return false;
+    }
+
+    header.type = (StreamFrameType)type;
+    header.stream = readInteger(buffer + 1, 4);
+    header.length = readInteger(buffer + 5, 4);
+
+    return header.stream != 0 && (header.type != StreamFrameType::StreamData || header.length <= STREAM_FRAME_SIZE);
+}
+
+void StreamHeader::encodePreface(char* buffer)
+{
+    memcpy(buffer, STREAM_MAGIC, 4);
+
+    writeInteger(buffer + 4, STREAM_VERSION, 1);
+}
+
+bool StreamHeader::decodePreface(const char* buffer)
+{
+    return memcmp(buffer, STREAM_MAGIC, 4) == 0 && readInteger(buffer + 4, 1) == STREAM_VERSION;
+}
+
+DatagramHeader::DatagramHeader() {}
+
+DatagramHeader::DatagramHeader(const DatagramType type, const uint32_t token, const uint64_t sequence, const uint64_t timestamp) :
+    type(type), token(token), sequence(sequence), timestamp(timestamp) {}
+
+void DatagramHeader::encode(char* buffer) const
+{
+    writeInteger(buffer, DATAGRAM_VERSION, 1);
+    writeInteger(buffer + 1, type, 1);
+    writeInteger(buffer + 2, token, 4);
+    writeInteger(buffer + 6, sequence, 8);
+    writeInteger(buffer + 14, timestamp, 8);
+}
+
+bool DatagramHeader::decode(const char* buffer, const uint64_t size, DatagramHeader& header)
+{
+    if (size < DATAGRAM_HEADER_SIZE || size > DATAGRAM_SIZE || readInteger(buffer, 1) != DATAGRAM_VERSION)
+    {
+        return false;
+    }
+
+    const uint8_t type = readInteger(buffer + 1, 1);
+
+    if (type != DatagramType::DatagramData && type != DatagramType::DatagramAck && type != DatagramType::DatagramClose)
+    {
+        return false;
+    }
+
+    header.type = (DatagramType)type;
+    header.token = readInteger(buffer + 2, 4);
+    header.sequence = readInteger(buffer + 6, 8);
+    header.timestamp = readInteger(buffer + 14, 8);
+
+    return true;
+}
+
+uint64_t SelectiveAck::encode(char* buffer, const uint64_t base) const
+{
+    char* bitmap = buffer + DATAGRAM_ACK_SIZE;
+
+    uint64_t length = 0;
+
+    for (const std::pair<uint64_t, uint64_t>& range : ranges)
+    {
+        if (range.second <= base)
+        {
+            continue;
+        }
+
+        const uint64_t start = range.first > base ? range.first - base : 0;
+        const uint64_t end = range.second - base < DATAGRAM_SACK_SIZE * 8 ? range.second - base : DATAGRAM_SACK_SIZE * 8;
+
+        if (start >= end)
+        {
+            break;
+        }
+
+        if ((end + 7) / 8 > length)
+        {
+            memset(bitmap + length, 0, (end + 7) / 8 - length);
+
+            length = (end + 7) / 8;
+        }
+
+        for (uint64_t i = start; i < end; i++)
+        {
+            bitmap[i / 8] |= 1 << (i % 8);
+        }
+    }
+
+    writeInteger(buffer, window, 4);
+    writeInteger(buffer + 4, length, 2);
+
+    return DATAGRAM_ACK_SIZE + length;
+}
+
+bool SelectiveAck::decode(const char* buffer, const uint64_t size, const uint64_t base, SelectiveAck& ack)
+{
+    if (size < DATAGRAM_ACK_SIZE)
+    {
+        return false;
+    }
+
+    ack.window = readInteger(buffer, 4);
+
+    const uint64_t length = readInteger(buffer + 4, 2);
+
+    if (length > DATAGRAM_SACK_SIZE || size < DATAGRAM_ACK_SIZE + length)
+    {
+        return false;
+    }
+
+    ack.ranges.clear();
+
+    for (uint64_t i = 0; i < length * 8; i++)
+    {
+        if (!(buffer[DATAGRAM_ACK_SIZE + i / 8] & (1 << (i % 8))))
+        {
+            continue;
+        }
+
+        if (!ack.ranges.empty() && ack.ranges.back().second == base + i)
+        {
+            ack.ranges.back().second++;
+        }
+
+        else
+        {
+            ack.ranges.push_back({ base + i, base + i + 1 });
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,305 @@
+#include "../include/hash.h"
+
+static const uint32_t SHA256_ROUNDS[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static uint32_t rotate(const uint32_t value, const unsigned int bits)
+{
+    return (value >> bits) | (value << (32 - bits));
+}
+
+static uint64_t rotateLeft(const uint64_t value, const unsigned int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static uint64_t readWord64(const unsigned char* data)
+{
+    uint64_t value;
+
+    memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+static uint64_t readWord32(const unsigned char* data)
+{
+    uint32_t value;
+
+    memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+static uint64_t xxhRound(uint64_t accumulator, const uint64_t input)
+{
+    accumulator += input * XXH64_PRIME_2;
+    accumulator = rotateLeft(accumulator, 31);
+
+    return accumulator * XXH64_PRIME_1;
+}
+
+static uint64_t xxhMerge(uint64_t accumulator, const uint64_t value)
+{
+    accumulator ^= xxhRound(0, value);
+
+    return accumulator * XXH64_PRIME_1 + XXH64_PRIME_4;
+}
+
+Sha256::Sha256() :
+    state { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 } {}
+
+std::string Sha256::digest(const char* data, const size_t size)
+{
+    Sha256 hash;
+
+    hash.update(data, size);
+
+    return hash.finish();
+}
+
+void Sha256::update(const char* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+
+    length += size;
+
+    if (buffered > 0)
+    {
+        const size_t count = size < 64 - buffered ? size : 64 - buffered;
+
+        memcpy(buffer + buffered, bytes, count);
+
+        buffered += count;
+        bytes += count;
+        size -= count;
+
+        if (buffered < 64)
+        {
+            return;
+        }
+
+        transform(buffer);
+
+        buffered = 0;
+    }
+
+    while (size >= 64)
+    {
+        transform(bytes);
+
+        bytes += 64;
+        size -= 64;
+    }
+
+    memcpy(buffer, bytes, size);
+
+    buffered = size;
+}
+
+std::string Sha256::finish()
+{
+    const uint64_t bits = length * 8;
+
+    const char padding = (char)0x80;
+    const char zero = 0;
+
+    update(&padding, 1);
+
+    while (buffered != 56)
+    {
+        update(&zero, 1);
+    }
+
+    char trailer[8];
+
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        trailer[i] = (bits >> (56 - i * 8)) & 0xff;
+    }
+
+    update(trailer, 8);
+
+    std::string result(SHA256_SIZE, '\0');
+
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        result[i * 4] = (state[i] >> 24) & 0xff;
+        result[i * 4 + 1] = (state[i] >> 16) & 0xff;
+        result[i * 4 + 2] = (state[i] >> 8) & 0xff;
+        result[i * 4 + 3] = state[i] & 0xff;
+    }
+
+    return result;
+}
+
+void Sha256::transform(const unsigned char* block)
+{
+    uint32_t words[64];
+
+    for (unsigned int i = 0; i < 16; i++)
+    {
+        words[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 | (uint32_t)block[i * 4 + 2] << 8 | block[i * 4 + 3];
+    }
+
+    for (unsigned int i = 16; i < 64; i++)
+    {
+        const uint32_t s0 = rotate(words[i - 15], 7) ^ rotate(words[i - 15], 18) ^ (words[i - 15] >> 3);
+        const uint32_t s1 = rotate(words[i - 2], 17) ^ rotate(words[i - 2], 19) ^ (words[i - 2] >> 10);
+
+        words[i] = words[i - 16] + s0 + words[i - 7] + s1;
+    }
+
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+    uint32_t f = state[5];
+    uint32_t g = state[6];
+    uint32_t h = state[7];
+
+    for (unsigned int i = 0; i < 64; i++)
+    {
+        const uint32_t t1 = h + (rotate(e, 6) ^ rotate(e, 11) ^ rotate(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_ROUNDS[i] + words[i];
+        const uint32_t t2 = (rotate(a, 2) ^ rotate(a, 13) ^ rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+uint64_t XXHash64::digest(const char* data, const size_t size, const uint64_t seed)
+{
+    const unsigned char* input = (const unsigned char*)data;
+    const unsigned char* end = input + size;
+
+    uint64_t hash = 0;
+
+    if (size >= 32)
+    {
+        uint64_t v1 = seed + XXH64_PRIME_1 + XXH64_PRIME_2;
+        uint64_t v2 = seed + XXH64_PRIME_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - XXH64_PRIME_1;
+
+        const unsigned char* limit = end - 32;
+
+        while (input <= limit)
+        {
+            v1 = xxhRound(v1, readWord64(input));
+            v2 = xxhRound(v2, readWord64(input + 8));
+            v3 = xxhRound(v3, readWord64(input + 16));
+            v4 = xxhRound(v4, readWord64(input + 24));
+
+            input += 32;
+        }
+
+        hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+
+        hash = xxhMerge(hash, v1);
+        hash = xxhMerge(hash, v2);
+        hash = xxhMerge(hash, v3);
+        hash = xxhMerge(hash, v4);
+    }
+
+    else
+    {
+        hash = seed + XXH64_PRIME_5;
+    }
+
+    hash += size;
+
+    while (end - input >= 8)
+    {
+        hash ^= xxhRound(0, readWord64(input));
+        hash = rotateLeft(hash, 27) * XXH64_PRIME_1 + XXH64_PRIME_4;
+
+        input += 8;
+    }
+
+    if (end - input >= 4)
+    {
+        hash ^= readWord32(input) * XXH64_PRIME_1;
+        hash = rotateLeft(hash, 23) * XXH64_PRIME_2 + XXH64_PRIME_3;
+
+        input += 4;
+    }
+
+    while (input < end)
+    {
+        hash ^= *input * XXH64_PRIME_5;
+        hash = rotateLeft(hash, 11) * XXH64_PRIME_1;
+
+        input++;
+    }
+
+    hash ^= hash >> 33;
+    hash *= XXH64_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= XXH64_PRIME_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+uint64_t HashTree::root(std::vector<uint64_t> leaves)
+{
+    if (leaves.empty())
+    {
+        return XXHash64::digest(nullptr, 0, 0);
+    }
+
+    while (leaves.size() > 1)
+    {
+        std::vector<uint64_t> parents;
+
+        for (size_t i = 0; i < leaves.size(); i += 2)
+        {
+            if (i + 1 == leaves.size())
+            {
+                parents.push_back(leaves[i]);
+
+                continue;
+            }
+
+            char pair[16];
+
+            for (unsigned int j = 0; j < 8; j++)
+            {
+                pair[j] = (leaves[i] >> (j * 8)) & 0xff;
+                pair[8 + j] = (leaves[i + 1] >> (j * 8)) & 0xff;
+            }
+
+            parents.push_back(XXHash64::digest(pair, 16, 1));
+        }
+
+        leaves = parents;
+    }
+
+    return leaves[0];
+}
@@ -1,92 +1,252 @@
 #include "../include/json.h"
 
-JSONObject::JSONObject(const std::unordered_map<std::string, const JSONObject*>& properties) :
-    properties(properties) {}
-
-JSONObject* JSONObject::deserialize(std::stringstream& stream)
+static const char* skipValue(const char* position, const char* end, const unsigned int depth)
 {
-    stream.get();
+    if (position == end)
+    {
+        return nullptr;
+    }
+
+    if (*position == '"')
+    {
+        const char* close = (const char*)memchr(position + 1, '"', end - position - 1);
+
+        return close ? close + 1 : nullptr;
+    }
+
+    if (*position != '{' || depth == 0)
+    {
+        return nullptr;
+    }
 
-    std::unordered_map<std::string, const JSONObject*> properties;
+    position++;
 
-    while (stream.peek() != '}' && !stream.eof())
+    while (position != end && *position != '}')
     {
-        std::string name;
+        const char* colon = (const char*)memchr(position, ':', end - position);
 
-        while (stream.peek() != ':' && !stream.eof())
+        if (!colon)
         {
-            name += stream.get();
+            return nullptr;
         }
 
-        if (stream.eof())
+        position = skipValue(colon + 1, end, depth - 1);
+
+        if (!position || position == end)
         {
             return nullptr;
         }
 
-        if (properties.count(name))
+        if (*position == ',')
+        {
+            position++;
+        }
+
+        else if (*position != '}')
         {
             return nullptr;
         }
+    }
 
-        stream.get();
+    return position == end ? nullptr : position + 1;
+}
 
-        if (stream.peek() == '"')
-        {
-            const JSONObject* str = JSONString::deserialize(stream);
+static bool hasDuplicates(const JSONView& object)
+{
+    size_t position = 0;
 
-            if (!str)
-            {
-                return nullptr;
-            }
+    std::string_view name;
+
+    JSONView value;
 
-            properties[name] = str;
+    while (true)
+    {
+        const size_t start = position;
+
+        if (!object.next(position, name, value))
+        {
+            return false;
         }
 
-        else if (stream.peek() == '{')
+        if (value.isObject() && hasDuplicates(value))
         {
-            const JSONObject* obj = JSONObject::deserialize(stream);
+            return true;
+        }
+
+        size_t earlier = 0;
+
+        std::string_view other;
+
+        JSONView skipped;
 
-            if (!obj)
+        while (earlier < start && object.next(earlier, other, skipped))
+        {
+            if (other == name)
             {
-                return nullptr;
+                return true;
             }
-
-            properties[name] = obj;
         }
+    }
+}
 
-        else
+static const JSONObject* getMissing()
+{
+    static const JSONObject missing({});
+
+    return &missing;
+}
+
+static std::optional<uint64_t> parseInteger(const std::string_view str)
+{
+    if (str.empty())
+    {
+        return std::nullopt;
+    }
+
+    uint64_t value = 0;
+
+    for (const char c : str)
+    {
+        if (c < '0' || c > '9')
         {
-            return nullptr;
+            return std::nullopt;
         }
 
-        if (stream.peek() == ',')
+        if (value > (UINT64_MAX - (c - '0')) / 10)
         {
-            stream.get();
+            return std::nullopt;
         }
 
-        else if (stream.peek() != '}')
+        value = value * 10 + (c - '0');
+    }
+
+    return value;
+}
+
+JSONView::JSONView() {}
+
+JSONView::JSONView(const std::string_view text) :
+    text(text) {}
+
+bool JSONView::deserialize(const std::string_view text, JSONView& view)
+{
+    if (text.empty() || text[0] != '{')
+    {
+        return false;
+    }
+
+    const char* end = skipValue(text.data(), text.data() + text.size(), JSON_MAX_DEPTH);
+
+    if (!end)
+    {
+        return false;
+    }
+
+    view = JSONView(text.substr(0, end - text.data()));
+
+    return !hasDuplicates(view);
+}
+
+JSONView JSONView::getProperty(const std::string_view name) const
+{
+    size_t position = 0;
+
+    std::string_view property;
+
+    JSONView value;
+
+    while (next(position, property, value))
+    {
+        if (property == name)
         {
-            return nullptr;
+            return value;
         }
     }
 
-    if (stream.eof())
+    return JSONView();
+}
+
+bool JSONView::next(size_t& position, std::string_view& name, JSONView& value) const
+{
+    if (!isObject())
     {
-        return nullptr;
+        return false;
     }
 
-    stream.get();
+    if (position == 0)
+    {
+        position = 1;
+    }
 
-    return new JSONObject(properties);
+    if (position >= text.size() || text[position] == '}')
+    {
+        return false;
+    }
+
+    const char* start = text.data() + position;
+    const char* end = text.data() + text.size();
+
+    const char* colon = (const char*)memchr(start, ':', end - start);
+    const char* close = colon ? skipValue(colon + 1, end, JSON_MAX_DEPTH) : nullptr;
+
+    if (!close)
+    {
+        return false;
+    }
+
+    name = std::string_view(start, colon - start);
+    value = JSONView(std::string_view(colon + 1, close - colon - 1));
+
+    position = close - text.data();
+
+    if (position < text.size() && text[position] == ',')
+    {
+        position++;
+    }
+
+    return true;
 }
 
-void JSONObject::serialize(std::stringstream& stream) const
+bool JSONView::isObject() const
 {
-    stream << '{';
+    return !text.empty() && text[0] == '{';
+}
 
-    bool first = true;
+std::optional<std::string_view> JSONView::asString() const
+{
+    if (text.size() < 2 || text[0] != '"')
+    {
+        return std::nullopt;
+    }
+
+    return text.substr(1, text.size() - 2);
+}
+
+std::optional<uint64_t> JSONView::asInteger() const
+{
+    const std::optional<std::string_view> str = asString();
 
+    return str ? parseInteger(str.value()) : std::nullopt;
+}
+
+JSONObject::JSONObject(const std::unordered_map<std::string, const JSONObject*>& properties) :
+    properties(properties) {}
+
+JSONObject::~JSONObject()
+{
     for (const std::pair<std::string, const JSONObject*> property : properties)
+    {
+        delete property.second;
+    }
+}
+
+void JSONObject::serialize(std::string& buffer) const
+{
+    buffer += '{';
+
+    bool first = true;
+
+    for (const std::pair<const std::string, const JSONObject*>& property : properties)
     {
         if (first)
         {
@@ -95,25 +255,23 @@ void JSONObject::serialize(std::stringstream& stream) const
 
         else
         {
-            stream << ',';
+            buffer += ',';
         }
 
-        stream << property.first << ':';
+        buffer.append(property.first);
+        buffer += ':';
 
-        property.second->serialize(stream);
+        property.second->serialize(buffer);
     }
 
-    stream << '}';
+    buffer += '}';
 }
 
 const JSONObject* JSONObject::getProperty(const std::string name) const
 {
-    if (properties.count(name))
-    {
-        return properties.at(name);
-    }
+    const std::unordered_map<std::string, const JSONObject*>::const_iterator property = properties.find(name);
 
-    return new JSONObject({});
+    return property != properties.end() ? property->second : getMissing();
 }
 
 std::optional<std::string> JSONObject::asString() const
@@ -121,65 +279,216 @@ std::optional<std::string> JSONObject::asString() const
     return std::nullopt;
 }
 
+std::optional<uint64_t> JSONObject::asInteger() const
+{
+    return std::nullopt;
+}
+
 JSONString::JSONString(const std::string str) :
     JSONObject({}), str(str) {}
 
-JSONString* JSONString::deserialize(std::stringstream& stream)
+void JSONString::serialize(std::string& buffer) const
 {
-    stream.get();
+    buffer += '"';
+    buffer.append(str);
+    buffer += '"';
+}
+
+std::optional<std::string> JSONString::asString() const
+{
+    return str;
+}
+
+std::optional<uint64_t> JSONString::asInteger() const
+{
+    return parseInteger(str);
+}
 
-    std::string str;
+JSONArenaObject::JSONArenaObject(const JSONArenaProperty* entries, const size_t count) :
+    JSONObject({}), entries(entries), count(count) {}
 
-    while (stream.peek() != '"' && !stream.eof())
+JSONArenaObject::~JSONArenaObject()
+{
+    for (size_t i = 0; i < count; i++)
     {
-        str += stream.get();
+        entries[i].value->~JSONObject();
     }
+}
+
+void JSONArenaObject::serialize(std::string& buffer) const
+{
+    buffer += '{';
 
-    if (stream.eof())
+    for (size_t i = 0; i < count; i++)
     {
-        return nullptr;
+        if (i > 0)
+        {
+            buffer += ',';
+        }
+
+        buffer.append(entries[i].name);
+        buffer += ':';
+
+        entries[i].value->serialize(buffer);
     }
 
-    stream.get();
+    buffer += '}';
+}
 
-    return new JSONString(str);
+const JSONObject* JSONArenaObject::getProperty(const std::string name) const
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (entries[i].name == name)
+        {
+            return entries[i].value;
+        }
+    }
+
+    return getMissing();
 }
 
-void JSONString::serialize(std::stringstream& stream) const
+JSONArenaString::JSONArenaString(const std::string_view str) :
+    JSONObject({}), str(str) {}
+
+void JSONArenaString::serialize(std::string& buffer) const
 {
-    stream << '"' << str << '"';
+    buffer += '"';
+    buffer.append(str);
+    buffer += '"';
 }
 
-std::optional<std::string> JSONString::asString() const
+std::optional<std::string> JSONArenaString::asString() const
 {
-    return str;
+    return std::string(str);
+}
+
+std::optional<uint64_t> JSONArenaString::asInteger() const
+{
+    return parseInteger(str);
+}
+
+JSONArena::JSONArena() {}
+
+JSONArena::~JSONArena()
+{
+    while (block)
+    {
+        char* previous = nullptr;
+
+        memcpy(&previous, block, sizeof(previous));
+
+        delete[] block;
+
+        block = previous;
+    }
+}
+
+const JSONObject* JSONArena::build(const JSONView& view)
+{
+    if (const std::optional<std::string_view> str = view.asString())
+    {
+        return new (allocate(sizeof(JSONArenaString))) JSONArenaString(copy(str.value()));
+    }
+
+    size_t count = 0;
+    size_t position = 0;
+
+    std::string_view name;
+
+    JSONView value;
+
+    while (view.next(position, name, value))
+    {
+        count++;
+    }
+
+    JSONArenaProperty* entries = (JSONArenaProperty*)allocate(count * sizeof(JSONArenaProperty));
+
+    position = 0;
+
+    for (size_t i = 0; i < count && view.next(position, name, value); i++)
+    {
+        new (entries + i) JSONArenaProperty({ copy(name), build(value) });
+    }
+
+    return new (allocate(sizeof(JSONArenaObject))) JSONArenaObject(entries, count);
+}
+
+void* JSONArena::allocate(const size_t size)
+{
+    const size_t alignment = alignof(std::max_align_t);
+    const size_t rounded = (size + alignment - 1) / alignment * alignment;
+
+    if (!block || used + rounded > capacity)
+    {
+        capacity = std::max<size_t>(alignment + rounded, JSON_ARENA_BLOCK);
+
+        char* next = new char[capacity];
+
+        memcpy(next, &block, sizeof(block));
+
+        block = next;
+
+        used = alignment;
+    }
+
+    void* pointer = block + used;
+
+    used += rounded;
+
+    return pointer;
+}
+
+std::string_view JSONArena::copy(const std::string_view text)
+{
+    char* data = (char*)allocate(text.size());
+
+    memcpy(data, text.data(), text.size());
+
+    return std::string_view(data, text.size());
 }
 
 Message::Message(const JSONObject* data) :
     data(data) {}
 
-Message* Message::deserialize(std::stringstream& stream)
+Message::Message(const JSONObject* data, const uint16_t flags, const uint64_t payloadSize) :
+    data(data), flags(flags), payloadSize(payloadSize) {}
+
+Message::Message(const JSONView& view, const uint16_t flags, const uint64_t payloadSize) :
+    flags(flags), payloadSize(payloadSize), parsed(true)
 {
-    char buffer[9];
+    data = arena.build(view);
+}
 
-    stream.get(buffer, 9);
+Message::~Message()
+{
+    if (parsed)
+    {
+        data->~JSONObject();
+    }
 
-    if (strncmp(buffer, "squirrel", 8) != 0)
+    else
     {
-        return nullptr;
+        delete data;
     }
+}
+
+Message* Message::deserialize(const std::string_view text)
+{
+    JSONView view;
 
-    if (stream.peek() != '{')
+    if (text.substr(0, 8) != "squirrel" || !JSONView::deserialize(text.substr(8), view))
     {
         return nullptr;
     }
 
-    return new Message(JSONObject::deserialize(stream));
+    return new Message(view, 0, 0);
 }
 
-void Message::serialize(std::stringstream& stream) const
+void Message::serialize(std::string& buffer) const
 {
-    stream << 's' << 'q' << 'u' << 'i' << 'r' << 'r' << 'e' << 'l';
+    buffer.append("squirrel");
 
-    data->serialize(stream);
+    data->serialize(buffer);
 }
@@ -1,3 +1,4 @@
+#include "../include/benchmark.h"
 #include "../include/errors.h"
 #include "../include/flags.h"
 #include "../include/network.h"
@@ -10,6 +11,7 @@
 #include <iostream>
 #include <optional>
 #include <string>
+#include <thread>
 
 int init(const int argc, char** argv, MainThreadQueue* mainThreadQueue, ErrorHandler* errorHandler, NetworkManager* networkManager, FileManager* fileManager, ProcessManager* processManager)
 {
@@ -22,11 +24,22 @@ int init(const int argc, char** argv, MainThreadQueue* mainThreadQueue, ErrorHan
         return 1;
     }
 
+    networkManager->setStreamCount(flags->streams);
+    networkManager->setDeduplicate(flags->dedup);
+    networkManager->setCompression(flags->compress);
+    networkManager->setIoUring(flags->ioUring);
+    networkManager->setConcurrency(flags->concurrency);
+    networkManager->setBandwidth(flags->bandwidth);
+    networkManager->setPeerBandwidth(flags->peerBandwidth);
+    networkManager->setTransferBandwidth(flags->transferBandwidth);
+    networkManager->setDatagram(flags->udp);
+    networkManager->setImpairment(flags->loss, flags->latency);
+
     if (flags->type == LaunchType::Service)
     {
-        networkManager->beginService([=](const std::string ip)
+        networkManager->beginService(fileManager->getReceivePath(), [=](const std::string ip, const std::filesystem::path path)
         {
-            std::vector<std::string> args = { "--receive", ip };
+            std::vector<std::string> args = { "--receive", ip, path.string() };
 
             if (!processManager->createProcess(args))
             {
@@ -44,23 +57,60 @@ int init(const int argc, char** argv, MainThreadQueue* mainThreadQueue, ErrorHan
     {
         Renderer* renderer = new Renderer(mainThreadQueue, errorHandler, networkManager, fileManager);
 
-        networkManager->beginReceive(flags->ip, [=](const std::string name, const std::string& data)
+        if (!flags->paths.empty())
         {
+            ReceiveResult* result = new StagedResult(flags->paths[0]);
+
             mainThreadQueue->push([=]()
             {
-                renderer->setupReceive(name, data);
+                renderer->setupReceive(result->getName(), result);
             });
-        });
+        }
+
+        else
+        {
+            networkManager->beginReceive(flags->ip, fileManager->getReceivePath(), [=](const std::string name, ReceiveResult* result)
+            {
+                mainThreadQueue->push([=]()
+                {
+                    renderer->setupReceive(name, result);
+                });
+            });
+        }
 
         renderer->setupMain();
         renderer->run();
     }
 
+    else if (flags->type == LaunchType::Benchmark)
+    {
+        const BenchmarkRunner* benchmark = new BenchmarkRunner(errorHandler, networkManager);
+
+        bool running = true;
+
+        std::thread thread([=, &running]()
+        {
+            benchmark->run(flags->paths.empty() ? "" : flags->paths[0], flags->streams);
+
+            mainThreadQueue->push([&]()
+            {
+                running = false;
+            });
+        });
+
+        while (running)
+        {
+            mainThreadQueue->execute(true);
+        }
+
+        thread.join();
+    }
+
     else
     {
         Renderer* renderer = new Renderer(mainThreadQueue, errorHandler, networkManager, fileManager);
 
-        renderer->setPath(flags->path);
+        renderer->setPaths(std::vector<std::filesystem::path>(flags->paths.begin(), flags->paths.end()));
         renderer->setupMain();
         renderer->run();
     }
@@ -1,7 +1,101 @@
 #include "../include/network.h"
 
+static bool offersKind(const std::string_view kinds, const std::string kind)
+{
+    return ("," + std::string(kinds) + ",").find("," + kind + ",") != std::string::npos;
+}
+
+static std::string& getMessageBuffer()
+{
+    thread_local std::string buffer;
+
+    buffer.clear();
+    buffer.reserve(MESSAGE_BUFFER_SIZE);
+
+    return buffer;
+}
+
+static void encodeFrame(const Message* message, std::string& frame)
+{
+    frame.assign(FRAME_HEADER_SIZE, '\0');
+
+    message->data->serialize(frame);
+
+    const FrameType type = message->payloadSize > 0 ? FrameType::Data : FrameType::Control;
+
+    FrameHeader(type, message->flags, frame.size() - FRAME_HEADER_SIZE, message->payloadSize).encode(frame.data());
+}
+
+static void encodeFrame(const ProtocolMessage& message, const uint16_t flags, const uint64_t payloadSize, std::string& frame)
+{
+    frame.assign(FRAME_HEADER_SIZE, '\0');
+
+    message.encode(frame);
+
+    const FrameType type = payloadSize > 0 ? FrameType::Data : FrameType::Control;
+
+    FrameHeader(type, flags, frame.size() - FRAME_HEADER_SIZE, payloadSize).encode(frame.data());
+}
+
+static bool encodeDatagram(const Message* message, std::string& datagram)
+{
+    message->serialize(datagram);
+
+    datagram += '\0';
+
+    return datagram.size() <= BUFFER_SIZE;
+}
+
+bool TCPSocket::sendMessage(const Message* message, const char* payload, const uint64_t size) const
+{
+    std::string& frame = getMessageBuffer();
+
+    encodeFrame(message, frame);
+
+    return sendVectored(frame.data(), frame.size(), payload, size);
+}
+
+bool TCPSocket::sendMessage(const ProtocolMessage& message, const uint16_t flags, const char* payload, const uint64_t size) const
+{
+    std::string& frame = getMessageBuffer();
+
+    encodeFrame(message, flags, size, frame);
+
+    return sendVectored(frame.data(), frame.size(), payload, size);
+}
+
+Message* TCPSocket::receive() const
+{
+    std::string buffer;
+
+    FrameHeader header;
+
+    JSONView message;
+
+    if (!receiveMessage(buffer, header, message))
+    {
+        return nullptr;
+    }
+
+    return new Message(message, header.flags, header.payloadLength);
+}
+
+bool TCPSocket::receiveMessage(std::string& buffer, FrameHeader& header, JSONView& message) const
+{
+    char data[FRAME_HEADER_SIZE];
+
+    if (!receivePayload(data, FRAME_HEADER_SIZE) || !FrameHeader::decode(data, header) || header.messageLength > FRAME_MESSAGE_LIMIT)
+    {
+        return false;
+    }
+
+    buffer.resize(header.messageLength);
+
+    return receivePayload(buffer.data(), header.messageLength) && JSONView::deserialize(buffer, message);
+}
+
 NetworkManager::NetworkManager(ErrorHandler* errorHandler, const std::string name, const std::string address) :
-    errorHandler(errorHandler), name(name), address(address)
+    errorHandler(errorHandler), name(name), address(address), scheduler(std::bind(&NetworkManager::sendTransfer, this, std::placeholders::_1))
 {
     if (name.empty())
     {
@@ -14,8 +108,15 @@ NetworkManager::NetworkManager(ErrorHandler* errorHandler, const std::string nam
     }
 }
 
-void NetworkManager::beginService(const std::function<void(const std::string)> handleConnect)
+void NetworkManager::beginService(const std::filesystem::path directory, const std::function<void(const std::string, const std::filesystem::path)> handleReceive)
 {
+    if (!reactor.start())
+    {
+        errorHandler->handle(SquirrelSocketException("Failed to start event loop."));
+
+        return;
+    }
+
     broadcastSocket = newUDPSocket();
 
     if (!broadcastSocket->create(address))
@@ -32,90 +133,6 @@ void NetworkManager::beginService(const std::function<void(const std::string)> h
         return;
     }
 
-    broadcastThread = std::thread([=]()
-    {
-        std::chrono::high_resolution_clock clock;
-        std::chrono::time_point<std::chrono::high_resolution_clock> last;
-
-        while (broadcastSocket->isAlive())
-        {
-            if ((clock.now() - last).count() >= 1e9)
-            {
-                const Message* broadcastMessage = new Message(new JSONObject(
-                {
-                    { "type", new JSONString("broadcast") },
-                    { "name", new JSONString(name) },
-                    { "ip", new JSONString(address) }
-                }));
-
-                if (!broadcastSocket->socketSend(broadcastMessage, "255.255.255.255", BROADCAST_PORT))
-                {
-                    errorHandler->handle(SquirrelSocketException("Failed to broadcast message."));
-
-                    return;
-                }
-
-                last = clock.now();
-            }
-        }
-    });
-
-    responseThread = std::thread([=]()
-    {
-        while (const Message* message = broadcastSocket->receive())
-        {
-            const std::optional<std::string> type = message->data->getProperty("type")->asString();
-
-            if (type == "available")
-            {
-                const std::optional<std::string> name = message->data->getProperty("name")->asString();
-                const std::optional<std::string> ip = message->data->getProperty("ip")->asString();
-
-                if (name && ip && ip != address)
-                {
-                    const Message* response = new Message(new JSONObject(
-                    {
-                        { "type", new JSONString("response") },
-                        { "name", new JSONString(name.value()) },
-                        { "ip", new JSONString(ip.value()) }
-                    }));
-
-                    serviceSocket->socketSend(response);
-                }
-            }
-
-            else if (type == "broadcast")
-            {
-                const std::optional<std::string> ip = message->data->getProperty("ip")->asString();
-
-                if (ip && ip != address)
-                {
-                    const Message* response = new Message(new JSONObject(
-                    {
-                        { "type", new JSONString("available") },
-                        { "name", new JSONString(name) },
-                        { "ip", new JSONString(address) }
-                    }));
-
-                    if (!broadcastSocket->socketSend(response, ip.value(), BROADCAST_PORT))
-                    {
-                        errorHandler->handle(SquirrelSocketException("Failed to respond to broadcast."));
-
-                        return;
-                    }
-                }
-            }
-
-            else if (type == "connect")
-            {
-                if (const std::optional<std::string> ip = message->data->getProperty("ip")->asString())
-                {
-                    handleConnect(ip.value());
-                }
-            }
-        }
-    });
-
     serviceSocket = newTCPSocket();
 
     if (!serviceSocket->create())
@@ -139,60 +156,76 @@ void NetworkManager::beginService(const std::function<void(const std::string)> h
         return;
     }
 
-    serviceThread = std::thread([=]()
+    if (!broadcastSocket->setBlocking(false) || !serviceSocket->setBlocking(false))
+    {
+        errorHandler->handle(SquirrelSocketException("Failed to configure socket."));
+
+        return;
+    }
+
+    broadcastTimer = reactor.addTimer(BROADCAST_INTERVAL, true, [=]()
     {
-        while (serviceSocket->isAlive())
+        const Message* broadcastMessage = new Message(new JSONObject(
         {
-            if (!serviceSocket->socketAccept())
-            {
-                errorHandler->handle(SquirrelSocketException("Failed to accept connection."));
+            { "type", new JSONString("broadcast") },
+            { "name", new JSONString(name) },
+            { "ip", new JSONString(address) }
+        }));
 
-                return;
-            }
+        if (!broadcastSocket->socketSend(broadcastMessage, "255.255.255.255", BROADCAST_PORT))
+        {
+            errorHandler->handle(SquirrelSocketException("Failed to broadcast message."));
 
-            while (serviceSocket->isAlive())
-            {
-                const Message* message = serviceSocket->receive();
+            reactor.cancelTimer(broadcastTimer);
+        }
 
-                if (!message)
-                {
-                    errorHandler->handle(SquirrelSocketException("Failed to receive message from client."));
+        delete broadcastMessage;
+    });
 
-                    return;
-                }
+    transferListener = listenTransfer(TRANSFER_PORT);
 
-                if (const std::optional<std::string> type = message->data->getProperty("type")->asString())
-                {
-                    if (type == "connect")
-                    {
-                        if (const std::optional<std::string> ip = message->data->getProperty("ip")->asString())
-                        {
-                            beginConnect(ip.value());
-                        }
-
-                        else
-                        {
-                            errorHandler->handle(SquirrelSocketException("Invalid message format."));
-                        }
-                    }
+    if (!transferListener)
+    {
+        return;
+    }
 
-                    else
-                    {
-                        errorHandler->handle(SquirrelSocketException("Unknown message type \"" + type.value() + "\"."));
-                    }
-                }
+    receiveThread = std::thread([=]()
+    {
+        receiveQueued(directory, handleReceive);
+    });
 
-                else
-                {
-                    errorHandler->handle(SquirrelSocketException("Invalid message format."));
-                }
+    const bool watched = reactor.watch(broadcastSocket->getHandle(), ReactorEvent::Readable, [=](const unsigned int)
+    {
+        receiveDiscovery([=](const std::string ip)
+        {
+            {
+                std::lock_guard<std::mutex> guard(receiveLock);
+
+                receives.push(ip);
             }
-        }
+
+            receiveSignal.notify_all();
+        });
+    }) && reactor.watch(serviceSocket->getHandle(), ReactorEvent::Readable, [=](const unsigned int)
+    {
+        acceptClients();
     });
+
+    if (!watched)
+    {
+        errorHandler->handle(SquirrelSocketException("Failed to watch socket."));
+    }
 }
 
 void NetworkManager::beginClient(const std::function<void(const std::string, const std::string)> handleResponse)
 {
+    if (!reactor.start())
+    {
+        errorHandler->handle(SquirrelSocketException("Failed to start event loop."));
+
+        return;
+    }
+
     serviceSocket = newTCPSocket();
 
     if (!serviceSocket->create())
@@ -202,7 +235,7 @@ void NetworkManager::beginClient(const std::function<void(const std::string, con
         return;
     }
 
-    serviceThread = std::thread([=]()
+    reactor.post([=]()
     {
         if (!serviceSocket->socketConnect(address, SERVICE_PORT))
         {
@@ -211,46 +244,81 @@ void NetworkManager::beginClient(const std::function<void(const std::string, con
             return;
         }
 
-        while (serviceSocket->isAlive())
+        if (!serviceSocket->setBlocking(false))
+        {
+            errorHandler->handle(SquirrelSocketException("Failed to configure socket."));
+
+            return;
+        }
+
+        serviceSocket->setProfile(SocketProfile::SocketControl);
+
+        FrameDecoder* decoder = new FrameDecoder();
+
+        decoder->setLimit(FrameType::Control, SERVICE_MESSAGE_SIZE, 0);
+
+        const bool watched = reactor.watch(serviceSocket->getHandle(), ReactorEvent::Readable, [=](const unsigned int)
         {
-            const Message* message = serviceSocket->receive();
+            std::string input;
+
+            const bool open = serviceSocket->receiveAvailable(input);
+
+            bool valid = decoder->feed(input.data(), input.size());
+
+            FrameHeader header;
 
-            if (message)
+            std::string_view text;
+            std::string_view payload;
+
+            while (valid && decoder->next(header, text, payload))
             {
-                if (const std::optional<std::string> type = message->data->getProperty("type")->asString())
+                JSONView view;
+
+                ProtocolMessage message;
+
+                if (!JSONView::deserialize(text, view))
                 {
-                    if (type == "response")
-                    {
-                        const std::optional<std::string> name = message->data->getProperty("name")->asString();
-                        const std::optional<std::string> ip = message->data->getProperty("ip")->asString();
-
-                        if (name && ip)
-                        {
-                            handleResponse(name.value(), ip.value());
-                        }
-
-                        else
-                        {
-                            errorHandler->handle(SquirrelSocketException("Invalid message format."));
-                        }
-                    }
+                    valid = false;
 
-                    else
-                    {
-                        errorHandler->handle(SquirrelSocketException("Unknown message type \"" + type.value() + "\"."));
-                    }
+                    break;
                 }
 
-                else
+                if (!ProtocolMessage::decode(view, message))
                 {
                     errorHandler->handle(SquirrelSocketException("Invalid message format."));
+
+                    continue;
+                }
+
+                switch (message.type)
+                {
+                    case MessageType::MessageResponse:
+                        handleResponse(std::string(message.getString(MessageField::FieldName)), std::string(message.getString(MessageField::FieldIp)));
+
+                        break;
+
+                    default:
+                        errorHandler->handle(SquirrelSocketException("Unknown message type \"" + std::string(message.typeName) + "\"."));
+
+                        break;
                 }
             }
 
-            else
+            if (!open || !valid || !decoder->isValid())
             {
                 errorHandler->handle(SquirrelSocketException("Failed to receive message from service."));
+
+                reactor.unwatch(serviceSocket->getHandle());
+
+                delete decoder;
             }
+        });
+
+        if (!watched)
+        {
+            errorHandler->handle(SquirrelSocketException("Failed to watch socket."));
+
+            delete decoder;
         }
     });
 }
@@ -271,694 +339,5963 @@ void NetworkManager::beginConnect(const std::string ip)
     }
 }
 
-void NetworkManager::beginTransfer(const std::filesystem::path path, const std::string ip)
+void NetworkManager::beginTransfer(const std::vector<std::filesystem::path> paths, const std::string ip)
 {
-    const Message* connect = new Message(new JSONObject(
-    {
-        { "type", new JSONString("connect") },
-        { "ip", new JSONString(ip) }
-    }));
-
-    if (!serviceSocket->socketSend(connect))
-    {
-        errorHandler->handle(SquirrelSocketException("Failed to send message to service."));
-
-        return;
-    }
+    scheduler.enqueue(paths, ip, nullptr);
+}
 
-    std::ifstream file(path, std::ios_base::binary);
+void NetworkManager::beginFanOut(const std::vector<std::filesystem::path> paths, const std::vector<std::string> ips)
+{
+    const std::shared_ptr<ChunkCache> cache = std::make_shared<ChunkCache>(FANOUT_WINDOW);
 
-    if (!file.is_open())
+    for (const std::string& ip : ips)
     {
-        errorHandler->handle(SquirrelFileException("Failed to open specified file."));
-
-        return;
+        scheduler.enqueue(paths, ip, cache);
     }
+}
 
-    std::stringstream stream;
-
-    stream << file.rdbuf();
-
-    file.close();
-
-    const std::string fileName = path.filename().string();
-    const std::string data = Base64::encode(stream.str());
-
+void NetworkManager::beginReceive(const std::string ip, const std::filesystem::path directory, const std::function<void(const std::string, ReceiveResult*)> handleReceive)
+{
     if (transferThread.joinable())
     {
         transferThread.join();
     }
 
-    const Message* message = new Message(new JSONObject(
+    transferThread = std::thread([=]()
     {
-        { "type", new JSONString("transfer") },
-        { "name", new JSONString(name) },
-        { "ip", new JSONString(address) },
-        { "file", new JSONString(fileName) },
-        { "data", new JSONString(data) }
-    }));
+        if (ReceiveResult* result = receiveFile(ip, TRANSFER_PORT, directory))
+        {
+            handleReceive(result->getName(), result);
+        }
+    });
+}
 
-    transferSocket = newTCPSocket();
+bool NetworkManager::sendFile(const std::filesystem::path path, const std::string ip, const unsigned int port, const unsigned int streams, TransferJob* job)
+{
+    return transferFile(path, path.filename().string(), ip, port, streams, job);
+}
+
+bool NetworkManager::sendFiles(const std::vector<std::filesystem::path> paths, const std::string ip, const unsigned int port, const unsigned int streams, TransferJob* job)
+{
+    Manifest manifest;
 
-    if (!transferSocket->create())
+    for (const std::filesystem::path& path : paths)
     {
-        errorHandler->handle(SquirrelSocketException("Failed to create socket."));
+        if (!manifest.add(path))
+        {
+            errorHandler->handle(SquirrelFileException("Failed to read \"" + path.string() + "\"."));
 
-        return;
+            return false;
+        }
     }
 
-    transferThread = std::thread([=]()
+    const std::string identity = name + ":" + manifest.encode();
+
+    const uint64_t key = XXHash64::digest(identity.data(), identity.size(), 0);
+
+    bool sent = false;
+
+    for (unsigned int attempt = 0; attempt < RESUME_ATTEMPTS && !sent; attempt++)
     {
-        if (!transferSocket->socketConnect(ip, TRANSFER_PORT))
+        if (attempt > 0)
         {
-            errorHandler->handle(SquirrelSocketException("Failed to connect to socket."));
-
-            return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(RESUME_INTERVAL * attempt));
         }
 
-        if (!transferSocket->socketSend(message))
-        {
-            errorHandler->handle(SquirrelSocketException("Failed to transfer file."));
+        sent = sendBundle(manifest, ip, port, key, job);
+    }
 
-            return;
-        }
+    if (!sent)
+    {
+        errorHandler->handle(SquirrelSocketException("Failed to transfer files."));
+
+        return false;
+    }
+
+    const std::vector<ManifestEntry>& entries = manifest.getEntries();
 
-        if (!transferSocket->destroy())
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (entries[i].type == EntryType::FileEntry && !entries[i].isBatched() && !transferFile(manifest.getSource(i), entries[i].name, ip, port, streams, job))
         {
-            errorHandler->handle(SquirrelSocketException("Failed to destroy socket."));
+            return false;
         }
-    });
+    }
+
+    return true;
 }
 
-void NetworkManager::beginReceive(const std::string ip, const std::function<void(const std::string, const std::string&)> handleReceive)
+bool NetworkManager::sendTransfer(TransferJob* job)
 {
-    if (transferThread.joinable())
+    const Message* connect = new Message(new JSONObject(
     {
-        transferThread.join();
-    }
+        { "type", new JSONString("connect") },
+        { "ip", new JSONString(job->ip) }
+    }));
 
-    transferSocket = newTCPSocket();
+    bool requested = false;
 
-    if (!transferSocket->create())
     {
-        errorHandler->handle(SquirrelSocketException("Failed to create socket."));
+        std::lock_guard<std::mutex> guard(serviceLock);
 
-        return;
+        requested = serviceSocket && serviceSocket->socketSend(connect);
     }
 
-    if (!transferSocket->socketBind(address, TRANSFER_PORT))
+    delete connect;
+
+    if (!requested)
     {
-        errorHandler->handle(SquirrelSocketException("Failed to bind socket."));
+        errorHandler->handle(SquirrelSocketException("Failed to send message to service."));
 
+        return false;
+    }
+
+    if (job->paths.size() == 1 && std::filesystem::is_regular_file(job->paths[0]))
+    {
+        return sendFile(job->paths[0], job->ip, TRANSFER_PORT, streamCount, job);
+    }
+
+    return sendFiles(job->paths, job->ip, TRANSFER_PORT, streamCount, job);
+}
+
+bool NetworkManager::transferFile(const std::filesystem::path path, const std::string fileName, const std::string ip, const unsigned int port, const unsigned int streams, TransferJob* job)
+{
+    std::error_code error;
+
+    const uint64_t size = std::filesystem::file_size(path, error);
+
+    if (error)
+    {
+        errorHandler->handle(SquirrelFileException("Failed to open specified file."));
+
+        return false;
+    }
+
+    const std::filesystem::file_time_type modified = std::filesystem::last_write_time(path, error);
+
+    const std::string identity = name + ":" + fileName + ":" + std::filesystem::absolute(path).string() + ":" + std::to_string(size) + ":" + std::to_string(modified.time_since_epoch().count());
+
+    const uint64_t key = XXHash64::digest(identity.data(), identity.size(), 0);
+
+    unsigned int count = streams;
+
+    if (count == 0)
+    {
+        std::lock_guard<std::mutex> guard(tunerLock);
+
+        count = tuners[ip].choose();
+    }
+
+    const uint64_t chunks = (size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    if (count > MAX_STREAMS)
+    {
+        count = MAX_STREAMS;
+    }
+
+    if (count > chunks)
+    {
+        count = chunks > 0 ? chunks : 1;
+    }
+
+    for (unsigned int attempt = 0; attempt < RESUME_ATTEMPTS; attempt++)
+    {
+        if (attempt > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(RESUME_INTERVAL * attempt));
+        }
+
+        ChunkReader reader(path);
+
+        if (!reader.isOpen() || reader.getSize() != size)
+        {
+            errorHandler->handle(SquirrelFileException("Failed to open specified file."));
+
+            return false;
+        }
+
+        const std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+
+        bool incremental = false;
+
+        if (!sendSession(reader, fileName, ip, port, count, key, job, incremental))
+        {
+            continue;
+        }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (attempt == 0 && !incremental && seconds > 0)
+        {
+            std::lock_guard<std::mutex> guard(tunerLock);
+
+            tuners[ip].record(count, size / seconds);
+        }
+
+        return true;
+    }
+
+    errorHandler->handle(SquirrelSocketException("Failed to transfer file."));
+
+    return false;
+}
+
+ReceiveResult* NetworkManager::receiveFile(const std::string ip, const unsigned int port, const std::filesystem::path directory)
+{
+    TCPSocket* listener = listenTransfer(port);
+
+    if (!listener)
+    {
+        return nullptr;
+    }
+
+    ReceiveResult* result = receiveTransfer(listener, ip, directory);
+
+    listener->destroy();
+
+    delete listener;
+
+    return result;
+}
+
+ReceiveResult* NetworkManager::receiveTransfer(const TCPSocket* listener, const std::string ip, const std::filesystem::path directory)
+{
+    ReceiveSink* sink = nullptr;
+    BundleSink* bundle = nullptr;
+
+    bool complete = receiveSessions(listener, ip, directory, sink, bundle);
+
+    if (complete && bundle)
+    {
+        const std::vector<ManifestEntry>& entries = bundle->getManifest().getEntries();
+
+        for (size_t i = 0; i < entries.size() && complete; i++)
+        {
+            if (entries[i].type != EntryType::FileEntry || entries[i].isBatched())
+            {
+                continue;
+            }
+
+            ReceiveSink* entrySink = nullptr;
+            BundleSink* nested = nullptr;
+
+            complete = receiveSessions(listener, ip, directory, entrySink, nested) && !nested;
+
+            complete = complete && entrySink->getName() == entries[i].name && entrySink->getSize() == entries[i].size && bundle->place(entrySink, i);
+
+            if (!complete && nested)
+            {
+                nested->discard();
+            }
+
+            delete entrySink;
+            delete nested;
+        }
+
+        complete = complete && bundle->isComplete();
+    }
+
+    if (!complete)
+    {
+        errorHandler->handle(SquirrelSocketException("Failed to receive file."));
+
+        if (bundle)
+        {
+            bundle->discard();
+        }
+
+        delete sink;
+        delete bundle;
+
+        return nullptr;
+    }
+
+    if (bundle)
+    {
+        return bundle;
+    }
+
+    return sink;
+}
+
+void NetworkManager::setStreamCount(const unsigned int streams)
+{
+    streamCount = streams;
+}
+
+void NetworkManager::setDeduplicate(const bool deduplicate)
+{
+    this->deduplicate = deduplicate;
+}
+
+void NetworkManager::setCompression(const bool compression)
+{
+    this->compression = compression;
+}
+
+void NetworkManager::setIoUring(const bool ioUring)
+{
+    this->ioUring = ioUring;
+}
+
+void NetworkManager::setConcurrency(const unsigned int concurrency)
+{
+    scheduler.setConcurrency(concurrency);
+}
+
+void NetworkManager::setBandwidth(const uint64_t bandwidth)
+{
+    scheduler.setBandwidth(bandwidth);
+}
+
+void NetworkManager::setPeerBandwidth(const uint64_t bandwidth)
+{
+    scheduler.setPeerBandwidth(bandwidth);
+}
+
+void NetworkManager::setPeerBandwidth(const std::string ip, const uint64_t bandwidth)
+{
+    scheduler.setPeerBandwidth(ip, bandwidth);
+}
+
+void NetworkManager::setTransferBandwidth(const uint64_t bandwidth)
+{
+    scheduler.setTransferBandwidth(bandwidth);
+}
+
+void NetworkManager::setTransferBandwidth(const uint64_t id, const uint64_t bandwidth)
+{
+    scheduler.setTransferBandwidth(id, bandwidth);
+}
+
+void NetworkManager::setDatagram(const bool datagram)
+{
+    this->datagram = datagram;
+}
+
+void NetworkManager::setImpairment(const unsigned int loss, const unsigned int latency)
+{
+    this->loss = loss;
+    this->latency = latency;
+}
+
+std::vector<TransferStatus> NetworkManager::getTransfers()
+{
+    return scheduler.getTransfers();
+}
+
+std::vector<StageCounters> NetworkManager::getPipelineCounters()
+{
+    std::lock_guard<std::mutex> guard(counterLock);
+
+    return pipelineCounters;
+}
+
+std::vector<SocketTuning> NetworkManager::getConnectionTunings()
+{
+    std::lock_guard<std::mutex> guard(counterLock);
+
+    return connectionTunings;
+}
+
+std::string NetworkManager::getLocalAddress() const
+{
+    return address;
+}
+
+void NetworkManager::receiveDiscovery(const std::function<void(const std::string)> handleConnect)
+{
+    char buffer[BUFFER_SIZE];
+
+    std::string sender;
+
+    unsigned int port = 0;
+
+    int64_t received = 0;
+
+    while ((received = broadcastSocket->receiveDatagram(buffer, BUFFER_SIZE, sender, port)) >= 0)
+    {
+        const std::string_view text(buffer, received);
+
+        JSONView view;
+
+        ProtocolMessage message;
+
+        if (text.substr(0, 8) != "squirrel" || !JSONView::deserialize(text.substr(8), view) || !ProtocolMessage::decode(view, message))
+        {
+            continue;
+        }
+
+        const std::string_view ip = message.getString(MessageField::FieldIp);
+
+        switch (message.type)
+        {
+            case MessageType::MessageAvailable:
+                if (ip != address)
+                {
+                    ProtocolMessage response(MessageType::MessageResponse);
+
+                    response.setString(MessageField::FieldName, message.getString(MessageField::FieldName));
+                    response.setString(MessageField::FieldIp, ip);
+
+                    for (TCPSocket* client : serviceClients)
+                    {
+                        client->sendMessage(response, 0, nullptr, 0);
+                    }
+                }
+
+                break;
+
+            case MessageType::MessageBroadcast:
+                if (ip != address)
+                {
+                    const Message* response = new Message(new JSONObject(
+                    {
+                        { "type", new JSONString("available") },
+                        { "name", new JSONString(this->name) },
+                        { "ip", new JSONString(address) }
+                    }));
+
+                    if (!broadcastSocket->socketSend(response, std::string(ip), BROADCAST_PORT))
+                    {
+                        errorHandler->handle(SquirrelSocketException("Failed to respond to broadcast."));
+                    }
+
+                    delete response;
+                }
+
+                break;
+
+            case MessageType::MessageConnect:
+                handleConnect(std::string(ip));
+
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+void NetworkManager::receiveQueued(const std::filesystem::path directory, const std::function<void(const std::string, const std::filesystem::path)> handleReceive)
+{
+    while (true)
+    {
+        std::string ip;
+
+        {
+            std::unique_lock<std::mutex> guard(receiveLock);
+
+            receiveSignal.wait(guard, [&]()
+            {
+                return !receives.empty();
+            });
+
+            ip = receives.front();
+
+            receives.pop();
+        }
+
+        ReceiveResult* result = receiveTransfer(transferListener, ip, directory);
+
+        if (!result)
+        {
+            continue;
+        }
+
+        const std::filesystem::path staging = directory / (".squirrel-" + std::to_string(std::random_device()()) + ".received");
+        const std::filesystem::path path = staging / result->getName();
+
+        std::error_code error;
+
+        std::filesystem::create_directories(staging, error);
+
+        if (error || !result->commit(path))
+        {
+            errorHandler->handle(SquirrelFileException("Failed to save file."));
+
+            result->discard();
+
+            std::filesystem::remove_all(staging, error);
+
+            delete result;
+
+            continue;
+        }
+
+        delete result;
+
+        handleReceive(ip, path);
+    }
+}
+
+void NetworkManager::acceptClients()
+{
+    while (TCPSocket* client = serviceSocket->acceptConnection())
+    {
+        if (!client->setBlocking(false))
+        {
+            errorHandler->handle(SquirrelSocketException("Failed to configure socket."));
+
+            client->destroy();
+
+            delete client;
+
+            continue;
+        }
+
+        client->setProfile(SocketProfile::SocketControl);
+
+        FrameDecoder* decoder = new FrameDecoder();
+
+        decoder->setLimit(FrameType::Control, SERVICE_MESSAGE_SIZE, 0);
+
+        serviceClients.push_back(client);
+
+        if (!reactor.watch(client->getHandle(), ReactorEvent::Readable, [=](const unsigned int)
+        {
+            receiveClient(client, decoder);
+        }))
+        {
+            errorHandler->handle(SquirrelSocketException("Failed to watch socket."));
+
+            serviceClients.pop_back();
+
+            client->destroy();
+
+            delete client;
+            delete decoder;
+        }
+    }
+}
+
+void NetworkManager::receiveClient(TCPSocket* client, FrameDecoder* decoder)
+{
+    std::string input;
+
+    const bool open = client->receiveAvailable(input);
+
+    bool valid = decoder->feed(input.data(), input.size());
+
+    FrameHeader header;
+
+    std::string_view text;
+    std::string_view payload;
+
+    while (valid && decoder->next(header, text, payload))
+    {
+        JSONView view;
+
+        ProtocolMessage message;
+
+        if (!JSONView::deserialize(text, view))
+        {
+            valid = false;
+
+            break;
+        }
+
+        if (!ProtocolMessage::decode(view, message))
+        {
+            errorHandler->handle(SquirrelSocketException("Invalid message format."));
+
+            continue;
+        }
+
+        switch (message.type)
+        {
+            case MessageType::MessageConnect:
+                beginConnect(std::string(message.getString(MessageField::FieldIp)));
+
+                break;
+
+            default:
+                errorHandler->handle(SquirrelSocketException("Unknown message type \"" + std::string(message.typeName) + "\"."));
+
+                break;
+        }
+    }
+
+    if (open && valid && decoder->isValid())
+    {
+        return;
+    }
+
+    reactor.unwatch(client->getHandle());
+
+    serviceClients.erase(std::find(serviceClients.begin(), serviceClients.end(), client));
+
+    client->destroy();
+
+    delete client;
+    delete decoder;
+}
+
+TCPSocket* NetworkManager::connectTransfer(const std::string ip, const unsigned int port, TransferJob* job)
+{
+    if (!reactor.start())
+    {
+        return nullptr;
+    }
+
+    const std::string peer = ip + ":" + std::to_string(port);
+
+    reactor.synchronize();
+
+    {
+        std::lock_guard<std::mutex> guard(connectionLock);
+
+        std::vector<std::shared_ptr<MuxConnection>>& pool = connections[peer];
+
+        pool.erase(std::remove_if(pool.begin(), pool.end(), [](const std::shared_ptr<MuxConnection>& connection)
+        {
+            if (connection->isAlive() && connection->isIdle(MUX_IDLE_TIMEOUT))
+            {
+                connection->shutdown();
+            }
+
+            return !connection->isAlive();
+        }), pool.end());
+
+        std::shared_ptr<MuxConnection> connection = nullptr;
+
+        for (const std::shared_ptr<MuxConnection>& candidate : pool)
+        {
+            if (candidate->getStreamCount() == 0)
+            {
+                connection = candidate;
+
+                break;
+            }
+        }
+
+        if (!connection && pool.size() >= MAX_STREAMS)
+        {
+            connection = *std::min_element(pool.begin(), pool.end(), [](const std::shared_ptr<MuxConnection>& a, const std::shared_ptr<MuxConnection>& b)
+            {
+                return a->getStreamCount() < b->getStreamCount();
+            });
+        }
+
+        if (connection)
+        {
+            if (TCPSocket* stream = connection->open(job))
+            {
+                return stream;
+            }
+        }
+    }
+
+    for (unsigned int i = 0; i < CONNECT_ATTEMPTS; i++)
+    {
+        TCPSocket* socket = newTCPSocket();
+
+        if (!socket->create())
+        {
+            delete socket;
+
+            return nullptr;
+        }
+
+        if (socket->socketConnect(ip, port))
+        {
+            const std::shared_ptr<MuxConnection> connection = std::make_shared<MuxConnection>(socket, &reactor, true, nullptr);
+
+            if (!connection->start())
+            {
+                return nullptr;
+            }
+
+            std::lock_guard<std::mutex> guard(connectionLock);
+
+            connections[peer].push_back(connection);
+
+            return connection->open(job);
+        }
+
+        socket->destroy();
+
+        delete socket;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(CONNECT_INTERVAL));
+    }
+
+    return nullptr;
+}
+
+TCPSocket* NetworkManager::listenTransfer(const unsigned int port)
+{
+    if (!reactor.start())
+    {
+        errorHandler->handle(SquirrelSocketException("Failed to start event loop."));
+
+        return nullptr;
+    }
+
+    TCPSocket* listener = new MuxListener(newTCPSocket(), &reactor);
+
+    if (!listener->create())
+    {
+        errorHandler->handle(SquirrelSocketException("Failed to create socket."));
+
+        delete listener;
+
+        return nullptr;
+    }
+
+    if (!listener->socketBind(address, port))
+    {
+        errorHandler->handle(SquirrelSocketException("Failed to bind socket."));
+
+        listener->destroy();
+
+        delete listener;
+
+        return nullptr;
+    }
+
+    if (!listener->socketListen())
+    {
+        errorHandler->handle(SquirrelSocketException("Failed to listen on socket."));
+
+        listener->destroy();
+
+        delete listener;
+
+        return nullptr;
+    }
+
+    return listener;
+}
+
+TCPSocket* NetworkManager::connectDatagram(const std::string ip, const unsigned int port, const uint32_t token, TransferJob* job)
+{
+    if (!reactor.start())
+    {
+        return nullptr;
+    }
+
+    UDPSocket* socket = newDatagramSocket();
+
+    if (!socket->create(address) || !socket->socketBind(address, 0))
+    {
+        if (socket->isAlive())
+        {
+            socket->destroy();
+        }
+
+        delete socket;
+
+        return nullptr;
+    }
+
+    const std::shared_ptr<DatagramConnection> connection = std::make_shared<DatagramConnection>(socket, &reactor, token, ip, port);
+
+    if (!connection->start())
+    {
+        connection->shutdown();
+
+        return nullptr;
+    }
+
+    return new DatagramStream(connection, job);
+}
+
+TCPSocket* NetworkManager::listenDatagram(const std::string ip, const uint32_t token, unsigned int& port)
+{
+    if (!reactor.start())
+    {
+        return nullptr;
+    }
+
+    UDPSocket* socket = newDatagramSocket();
+
+    if (!socket->create(address) || !socket->socketBind(address, 0) || (port = socket->getPort()) == 0)
+    {
+        if (socket->isAlive())
+        {
+            socket->destroy();
+        }
+
+        delete socket;
+
+        return nullptr;
+    }
+
+    const std::shared_ptr<DatagramConnection> connection = std::make_shared<DatagramConnection>(socket, &reactor, token, ip, 0);
+
+    if (!connection->start())
+    {
+        connection->shutdown();
+
+        return nullptr;
+    }
+
+    return new DatagramStream(connection, nullptr);
+}
+
+UDPSocket* NetworkManager::newDatagramSocket() const
+{
+    UDPSocket* socket = newUDPSocket();
+
+    if (loss > 0 || latency > 0)
+    {
+        return new ImpairedUDPSocket(socket, loss, latency);
+    }
+
+    return socket;
+}
+
+bool NetworkManager::receiveSessions(const TCPSocket* listener, const std::string ip, const std::filesystem::path directory, ReceiveSink*& sink, BundleSink*& bundle)
+{
+    bool complete = false;
+
+    for (unsigned int attempt = 0; attempt < RESUME_ATTEMPTS && !complete; attempt++)
+    {
+        TCPSocket* control = listener->acceptConnection();
+
+        if (!control && !listener->isAlive())
+        {
+            errorHandler->handle(SquirrelSocketException("Failed to accept connection."));
+
+            break;
+        }
+
+        if (!control)
+        {
+            continue;
+        }
+
+        std::string frame;
+
+        FrameHeader frameHeader;
+
+        JSONView view;
+
+        ProtocolMessage header;
+
+        if (control->receiveMessage(frame, frameHeader, view))
+        {
+            switch (ProtocolMessage::decode(view, header) ? header.type : MessageType::MessageUnknown)
+            {
+                case MessageType::MessageBundle:
+                    complete = !sink && receiveBundle(control, header, frameHeader.payloadLength, ip, directory, bundle);
+
+                    break;
+
+                case MessageType::MessageTransfer:
+                    complete = !bundle && receiveSession(listener, control, header, ip, directory, sink);
+
+                    break;
+
+                default:
+                    errorHandler->handle(SquirrelSocketException("Received incorrect message format."));
+
+                    break;
+            }
+        }
+
+        if (control->isAlive())
+        {
+            control->destroy();
+        }
+
+        delete control;
+    }
+
+    return complete;
+}
+
+bool NetworkManager::sendBundle(const Manifest& manifest, const std::string ip, const unsigned int port, const uint64_t key, TransferJob* job)
+{
+    TCPSocket* control = connectTransfer(ip, port, job);
+
+    if (!control)
+    {
+        return false;
+    }
+
+    const std::string data = manifest.encode();
+    const uint64_t size = manifest.getBatchSize();
+
+    const Message* header = new Message(new JSONObject(
+    {
+        { "type", new JSONString("bundle") },
+        { "name", new JSONString(name) },
+        { "ip", new JSONString(address) },
+        { "key", new JSONString(std::to_string(key)) },
+        { "size", new JSONString(std::to_string(size)) },
+        { "codecs", new JSONString(compression ? CODEC_LZ4 : "") }
+    }), 0, data.size());
+
+    const bool sent = control->sendMessage(header, data.data(), data.size());
+
+    delete header;
+
+    const Message* ready = sent ? control->receive() : nullptr;
+
+    const bool accepted = ready && ready->data->getProperty("type")->asString() == "ready";
+    const bool compressing = accepted && compression && ready->data->getProperty("codec")->asString() == CODEC_LZ4;
+
+    delete ready;
+
+    if (!accepted)
+    {
+        control->destroy();
+
+        delete control;
+
+        return false;
+    }
+
+    BatchReader reader(manifest);
+
+    Compressor compressor;
+
+    std::vector<char> buffer(CHUNK_SIZE);
+    std::vector<char> output(compressing ? Compressor::bound(CHUNK_SIZE) : 0);
+
+    bool failed = false;
+
+    for (uint64_t offset = 0; offset < size && !failed; offset += buffer.size())
+    {
+        const uint64_t length = size - offset < buffer.size() ? size - offset : buffer.size();
+
+        if (!reader.read(buffer.data(), length))
+        {
+            failed = true;
+
+            break;
+        }
+
+        const uint64_t compressed = compressing ? compressor.compressChunk(buffer.data(), length, output.data(), output.size()) : 0;
+
+        ProtocolMessage message(MessageType::MessageBatch);
+
+        message.setInteger(MessageField::FieldSize, length);
+        message.setInteger(MessageField::FieldHash, XXHash64::digest(buffer.data(), length, 0));
+
+        failed = !control->sendMessage(message, compressed > 0 ? FRAME_FLAG_COMPRESSED : 0, compressed > 0 ? output.data() : buffer.data(), compressed > 0 ? compressed : length);
+    }
+
+    const Message* footer = new Message(new JSONObject(
+    {
+        { "type", new JSONString("complete") }
+    }));
+
+    failed = failed || !control->socketSend(footer);
+
+    delete footer;
+
+    const Message* response = failed ? nullptr : control->receive();
+
+    const bool received = response && response->data->getProperty("type")->asString() == "received";
+
+    delete response;
+
+    control->destroy();
+
+    delete control;
+
+    return received;
+}
+
+bool NetworkManager::receiveBundle(const TCPSocket* control, const ProtocolMessage& header, const uint64_t payloadSize, const std::string ip, const std::filesystem::path directory, BundleSink*& bundle)
+{
+    const uint64_t key = header.getInteger(MessageField::FieldKey);
+    const uint64_t size = header.getInteger(MessageField::FieldSize);
+
+    if (header.getString(MessageField::FieldIp) != ip)
+    {
+        errorHandler->handle(SquirrelSocketException("Invalid connection."));
+
+        return false;
+    }
+
+    if (payloadSize > MANIFEST_MAX_SIZE)
+    {
+        errorHandler->handle(SquirrelSocketException("Received incorrect message format."));
+
+        return false;
+    }
+
+    std::string data(payloadSize, '\0');
+
+    Manifest manifest;
+
+    if (!control->receivePayload(data.data(), data.size()) || !Manifest::decode(data, manifest) || manifest.getBatchSize() != size)
+    {
+        errorHandler->handle(SquirrelSocketException("Received incorrect message format."));
+
+        return false;
+    }
+
+    if (!bundle)
+    {
+        bundle = new BundleSink(directory, key, manifest);
+    }
+
+    else if (bundle->getKey() != key || !bundle->restart())
+    {
+        errorHandler->handle(SquirrelSocketException("Received a different transfer."));
+
+        return false;
+    }
+
+    if (!bundle->isOpen())
+    {
+        errorHandler->handle(SquirrelFileException("Failed to create file."));
+
+        return false;
+    }
+
+    const std::string codec = offersKind(header.getString(MessageField::FieldCodecs), CODEC_LZ4) ? CODEC_LZ4 : "raw";
+
+    const Message* ready = new Message(new JSONObject(
+    {
+        { "type", new JSONString("ready") },
+        { "codec", new JSONString(codec) }
+    }));
+
+    const bool sent = control->socketSend(ready);
+
+    delete ready;
+
+    std::vector<char> buffer(CHUNK_SIZE);
+    std::vector<char> output(CHUNK_SIZE);
+
+    std::string frame;
+
+    while (sent)
+    {
+        FrameHeader frameHeader;
+
+        JSONView view;
+
+        ProtocolMessage message;
+
+        if (!control->receiveMessage(frame, frameHeader, view) || !ProtocolMessage::decode(view, message))
+        {
+            return false;
+        }
+
+        const uint64_t length = message.getInteger(MessageField::FieldSize);
+        const bool compressed = frameHeader.flags & FRAME_FLAG_COMPRESSED;
+        const uint64_t payloadSize = frameHeader.payloadLength;
+
+        if (message.type == MessageType::MessageComplete)
+        {
+            if (!bundle->finish())
+            {
+                return false;
+            }
+
+            const Message* response = new Message(new JSONObject(
+            {
+                { "type", new JSONString("received") }
+            }));
+
+            control->socketSend(response);
+
+            delete response;
+
+            return true;
+        }
+
+        if (message.type != MessageType::MessageBatch || length > output.size() || payloadSize > Compressor::bound(length))
+        {
+            return false;
+        }
+
+        if (compressed)
+        {
+            buffer.resize(Compressor::bound(CHUNK_SIZE));
+
+            if (codec != CODEC_LZ4 || !control->receivePayload(buffer.data(), payloadSize) || !Compressor::decompress(buffer.data(), payloadSize, output.data(), length))
+            {
+                return false;
+            }
+        }
+
+        else if (payloadSize != length || !control->receivePayload(output.data(), payloadSize))
+        {
+            return false;
+        }
+
+        if (XXHash64::digest(output.data(), length, 0) != message.getInteger(MessageField::FieldHash))
+        {
+            errorHandler->handle(SquirrelFileException("File failed integrity check."));
+
+            return false;
+        }
+
+        if (!bundle->write(output.data(), length))
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+bool NetworkManager::sendSession(ChunkReader& reader, const std::string fileName, const std::string ip, const unsigned int port, const unsigned int streams, const uint64_t key, TransferJob* job, bool& incremental)
+{
+    const std::string id = std::to_string(std::random_device()());
+
+    TCPSocket* control = connectTransfer(ip, port, job);
+
+    if (!control)
+    {
+        return false;
+    }
+
+    ChunkHasher hasher(reader.getFile(), reader.getSize());
+
+    const Message* header = new Message(new JSONObject(
+    {
+        { "type", new JSONString("transfer") },
+        { "name", new JSONString(name) },
+        { "ip", new JSONString(address) },
+        { "id", new JSONString(id) },
+        { "key", new JSONString(std::to_string(key)) },
+        { "file", new JSONString(fileName) },
+        { "size", new JSONString(std::to_string(reader.getSize())) },
+        { "streams", new JSONString(std::to_string(streams)) },
+        { "kind", new JSONString(deduplicate ? "delta,dedup" : "delta") },
+        { "codecs", new JSONString(compression ? CODEC_LZ4 : "") },
+        { "transports", new JSONString(datagram ? "udp" : "") }
+    }));
+
+    const bool sent = control->socketSend(header);
+
+    delete header;
+
+    const Message* resume = sent ? control->receive() : nullptr;
+
+    if (resume && resume->data->getProperty("type")->asString() == "signature")
+    {
+        const std::optional<uint64_t> blockSize = resume->data->getProperty("block")->asInteger();
+        const uint64_t signatureSize = resume->payloadSize;
+
+        delete resume;
+
+        incremental = true;
+
+        hasher.pushAll();
+
+        const bool streamed = blockSize && sendDelta(control, reader, blockSize.value(), signatureSize) && sendHashes(control, hasher);
+
+        const Message* response = streamed ? control->receive() : nullptr;
+
+        const bool received = response && response->data->getProperty("type")->asString() == "received";
+
+        delete response;
+
+        control->destroy();
+
+        delete control;
+
+        return received;
+    }
+
+    if (resume && resume->data->getProperty("type")->asString() == "store")
+    {
+        delete resume;
+
+        incremental = true;
+
+        hasher.pushAll();
+
+        const bool streamed = sendDeduplicated(control, reader) && sendHashes(control, hasher);
+
+        const Message* response = streamed ? control->receive() : nullptr;
+
+        const bool received = response && response->data->getProperty("type")->asString() == "received";
+
+        delete response;
+
+        control->destroy();
+
+        delete control;
+
+        return received;
+    }
+
+    std::vector<bool> completed((reader.getSize() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+    if (!resume || resume->data->getProperty("type")->asString() != "resume" || resume->payloadSize != (completed.size() + 7) / 8)
+    {
+        delete resume;
+
+        control->destroy();
+
+        delete control;
+
+        return false;
+    }
+
+    std::string bitmap(resume->payloadSize, '\0');
+
+    const bool compressing = compression && resume->data->getProperty("codec")->asString() == CODEC_LZ4;
+    const bool datagrams = resume->data->getProperty("transport")->asString() == "udp";
+
+    const std::optional<uint64_t> datagramPort = resume->data->getProperty("port")->asInteger();
+    const std::optional<uint64_t> token = resume->data->getProperty("token")->asInteger();
+
+    delete resume;
+
+    if (!control->receivePayload(bitmap.data(), bitmap.size()) || !ChunkMap::decode(bitmap, completed))
+    {
+        control->destroy();
+
+        delete control;
+
+        return false;
+    }
+
+    reader.skip(completed);
+
+    for (size_t i = 0; i < completed.size(); i++)
+    {
+        if (completed[i])
+        {
+            hasher.push(i * CHUNK_SIZE);
+        }
+    }
+
+    bool failed = false;
+
+    std::vector<TCPSocket*> sockets = { control };
+
+    if (datagrams)
+    {
+        TCPSocket* socket = datagramPort && token ? connectDatagram(ip, datagramPort.value(), token.value(), job) : nullptr;
+
+        if (socket)
+        {
+            sockets = { socket };
+        }
+
+        else
+        {
+            failed = true;
+        }
+    }
+
+    for (unsigned int i = 1; i < streams && !failed && !datagrams; i++)
+    {
+        TCPSocket* socket = connectTransfer(ip, port, job);
+
+        if (!socket)
+        {
+            failed = true;
+
+            break;
+        }
+
+        const Message* join = new Message(new JSONObject(
+        {
+            { "type", new JSONString("stream") },
+            { "ip", new JSONString(address) },
+            { "id", new JSONString(id) }
+        }));
+
+        if (!socket->socketSend(join))
+        {
+            failed = true;
+        }
+
+        delete join;
+
+        sockets.push_back(socket);
+    }
+
+    const unsigned int cores = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+
+    std::vector<Compressor> compressors(compressing ? cores : 0);
+
+    Pipeline pipeline;
+
+    ChunkCache* cache = job ? job->cache.get() : nullptr;
+
+    const std::string source = std::filesystem::absolute(reader.getPath()).string();
+
+    const bool zeroCopy = !compressing && !cache && !datagrams;
+
+    if (!zeroCopy)
+    {
+        pipeline.addStage("read", 1, [&](PipelineBlock* block, const unsigned int)
+        {
+            if (cache)
+            {
+                block->shared = cache->acquire(reader.getFile(), source, block->chunk);
+
+                return block->shared != nullptr;
+            }
+
+            block->data.resize(CHUNK_SIZE);
+
+            return reader.getFile().readAt(block->data.data(), block->chunk.size, block->chunk.offset);
+        });
+    }
+
+    pipeline.addStage("hash", 1, [&](PipelineBlock* block, const unsigned int)
+    {
+        if (zeroCopy)
+        {
+            hasher.push(block->chunk.offset);
+
+            return true;
+        }
+
+        hasher.record(block->chunk.offset, block->shared ? block->shared->hash : XXHash64::digest(block->data.data(), block->chunk.size, 0));
+
+        return true;
+    });
+
+    if (compressing)
+    {
+        pipeline.addStage("compress", cores, [&](PipelineBlock* block, const unsigned int worker)
+        {
+            if (block->shared)
+            {
+                block->compressed = cache->compress(block->shared.get(), block->chunk, compressors[worker]);
+
+                return true;
+            }
+
+            block->output.resize(Compressor::bound(CHUNK_SIZE));
+
+            block->compressed = compressors[worker].compressChunk(block->data.data(), block->chunk.size, block->output.data(), block->output.size());
+
+            return true;
+        });
+    }
+
+    pipeline.addStage("frame", 1, [&](PipelineBlock* block, const unsigned int)
+    {
+        ProtocolMessage message(MessageType::MessageChunk);
+
+        message.setInteger(MessageField::FieldOffset, block->chunk.offset);
+        message.setInteger(MessageField::FieldSize, block->chunk.size);
+
+        encodeFrame(message, block->compressed > 0 ? FRAME_FLAG_COMPRESSED : 0, block->compressed > 0 ? block->compressed : block->chunk.size, block->frame);
+
+        return true;
+    });
+
+    pipeline.addStage("write", sockets.size(), [&](PipelineBlock* block, const unsigned int worker)
+    {
+        if (zeroCopy)
+        {
+            return sockets[worker]->sendFileRange(block->frame.data(), block->frame.size(), reader.getFile(), block->chunk.offset, block->chunk.size);
+        }
+
+        const std::vector<char>& data = block->shared ? block->shared->data : block->data;
+        const std::vector<char>& output = block->shared ? block->shared->compressed : block->output;
+
+        const char* payload = block->compressed > 0 ? output.data() : data.data();
+        const uint64_t payloadSize = block->compressed > 0 ? block->compressed : block->chunk.size;
+
+        const bool sent = sockets[worker]->sendVectored(block->frame.data(), block->frame.size(), payload, payloadSize);
+
+        block->shared = nullptr;
+
+        return sent;
+    });
+
+    failed = failed || !pipeline.run([&](PipelineBlock* block)
+    {
+        return reader.next(block->chunk);
+    });
+
+    std::vector<SocketTuning> tunings;
+
+    for (TCPSocket* socket : sockets)
+    {
+        SocketTuning tuning;
+
+        if (socket->getTuning(tuning))
+        {
+            tunings.push_back(tuning);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(counterLock);
+
+        pipelineCounters = pipeline.getCounters();
+        connectionTunings = tunings;
+    }
+
+    if (job)
+    {
+        job->setConnections(tunings);
+    }
+
+    const Message* footer = new Message(new JSONObject(
+    {
+        { "type", new JSONString("complete") }
+    }));
+
+    for (TCPSocket* socket : sockets)
+    {
+        failed = failed || !socket->socketSend(footer);
+    }
+
+    delete footer;
+
+    for (TCPSocket* socket : sockets)
+    {
+        if (socket != control)
+        {
+            failed = !socket->destroy() || failed;
+
+            delete socket;
+        }
+    }
+
+    if (failed || !reader.isComplete() || !sendHashes(control, hasher))
+    {
+        control->destroy();
+
+        delete control;
+
+        return false;
+    }
+
+    const Message* response = control->receive();
+
+    const bool received = response && response->data->getProperty("type")->asString() == "received";
+
+    delete response;
+
+    control->destroy();
+
+    delete control;
+
+    return received;
+}
+
+bool NetworkManager::receiveSession(const TCPSocket* listener, TCPSocket* control, const ProtocolMessage& header, const std::string ip, const std::filesystem::path directory, ReceiveSink*& sink)
+{
+    const std::string id(header.getString(MessageField::FieldId));
+    const std::string fileName(header.getString(MessageField::FieldFile));
+    const uint64_t key = header.getInteger(MessageField::FieldKey);
+    const uint64_t size = header.getInteger(MessageField::FieldSize);
+    const uint64_t streams = header.getInteger(MessageField::FieldStreams);
+    const std::string_view kind = header.getString(MessageField::FieldKind);
+    const std::string_view codecs = header.getString(MessageField::FieldCodecs);
+    const std::string_view transports = header.getString(MessageField::FieldTransports);
+
+    if (header.getString(MessageField::FieldIp) != ip)
+    {
+        errorHandler->handle(SquirrelSocketException("Invalid connection."));
+
+        return false;
+    }
+
+    if (streams == 0 || streams > MAX_STREAMS)
+    {
+        errorHandler->handle(SquirrelSocketException("Received incorrect message format."));
+
+        return false;
+    }
+
+    // The file name comes from the peer and must stay one component inside the receive directory.
+
+    if (!Manifest::isSafe(fileName) || std::filesystem::path(fileName).filename() != fileName)
+    {
+        errorHandler->handle(SquirrelSocketException("Received an invalid file name."));
+
+        return false;
+    }
+
+    if (!sink)
+    {
+        sink = new ReceiveSink(directory, fileName, key, size);
+    }
+
+    if (!sink->isOpen())
+    {
+        errorHandler->handle(SquirrelFileException("Failed to create file."));
+
+        return false;
+    }
+
+    if (sink->getKey() != key || sink->getSize() != size)
+    {
+        errorHandler->handle(SquirrelSocketException("Received a different transfer."));
+
+        return false;
+    }
+
+    const std::vector<bool> completed = sink->getCompleted();
+
+    ChunkHasher hasher(sink->getFile(), size);
+
+    for (size_t i = 0; i < completed.size(); i++)
+    {
+        if (completed[i])
+        {
+            hasher.push(i * CHUNK_SIZE);
+        }
+    }
+
+    const std::filesystem::path basis = directory / std::filesystem::path(fileName).filename();
+
+    const bool fresh = std::find(completed.begin(), completed.end(), true) == completed.end();
+
+    const bool delta = fresh && offersKind(kind, "delta") && std::filesystem::is_regular_file(basis);
+    const bool deduplicated = fresh && !delta && offersKind(kind, "dedup");
+
+    if (delta || deduplicated)
+    {
+        const bool received = delta ? receiveDelta(control, basis, sink, hasher) : receiveDeduplicated(control, directory / ".squirrel-store", sink, hasher);
+
+        if (!received || !sink->flush() || !sink->isComplete() || !verifyHashes(control, hasher, sink))
+        {
+            return false;
+        }
+
+        const Message* response = new Message(new JSONObject(
+        {
+            { "type", new JSONString("received") }
+        }));
+
+        control->socketSend(response);
+
+        delete response;
+
+        return true;
+    }
+
+    const std::string bitmap = ChunkMap::encode(completed);
+
+    const std::string codec = offersKind(codecs, CODEC_LZ4) ? CODEC_LZ4 : "raw";
+
+    const uint32_t token = std::random_device()();
+
+    unsigned int datagramPort = 0;
+
+    TCPSocket* channel = offersKind(transports, "udp") ? listenDatagram(ip, token, datagramPort) : nullptr;
+
+    const Message* resume = new Message(new JSONObject(
+    {
+        { "type", new JSONString("resume") },
+        { "codec", new JSONString(codec) },
+        { "transport", new JSONString(channel ? "udp" : "tcp") },
+        { "port", new JSONString(std::to_string(datagramPort)) },
+        { "token", new JSONString(std::to_string(token)) }
+    }), 0, bitmap.size());
+
+    const bool sent = control->sendMessage(resume, bitmap.data(), bitmap.size());
+
+    delete resume;
+
+    if (!sent)
+    {
+        delete channel;
+
+        return false;
+    }
+
+    ChunkMap chunks(size, completed);
+
+    std::atomic<bool> failed = false;
+
+    std::vector<TCPSocket*> sockets;
+    std::vector<std::thread> threads;
+
+    std::mutex sessionLock;
+
+    bool closing = false;
+
+    // The first failure tears down every stream, so no thread is left waiting on a dead one.
+
+    const std::function<void()> fail = [&]()
+    {
+        std::lock_guard<std::mutex> guard(sessionLock);
+
+        failed = true;
+
+        if (closing)
+        {
+            return;
+        }
+
+        closing = true;
+
+        for (TCPSocket* socket : sockets)
+        {
+            socket->destroy();
+        }
+
+        control->destroy();
+    };
+
+    const std::function<void(const TCPSocket*)> receiveChunks = [&](const TCPSocket* socket)
+    {
+        std::vector<char> input;
+        std::vector<char> output;
+
+        std::string frame;
+
+        while (!failed)
+        {
+            FrameHeader frameHeader;
+
+            JSONView view;
+
+            ProtocolMessage message;
+
+            if (!socket->receiveMessage(frame, frameHeader, view) || !ProtocolMessage::decode(view, message))
+            {
+                fail();
+
+                return;
+            }
+
+            const uint64_t offset = message.getInteger(MessageField::FieldOffset);
+            const uint64_t length = message.getInteger(MessageField::FieldSize);
+            const bool compressed = frameHeader.flags & FRAME_FLAG_COMPRESSED;
+            const uint64_t payloadSize = frameHeader.payloadLength;
+
+            if (message.type == MessageType::MessageComplete)
+            {
+                return;
+            }
+
+            if (message.type != MessageType::MessageChunk || !chunks.mark(offset, length))
+            {
+                fail();
+
+                return;
+            }
+
+            bool written = false;
+
+            if (compressed && codec == CODEC_LZ4 && payloadSize <= Compressor::bound(length))
+            {
+                input.resize(Compressor::bound(CHUNK_SIZE));
+                output.resize(CHUNK_SIZE);
+
+                written = socket->receivePayload(input.data(), payloadSize) && Compressor::decompress(input.data(), payloadSize, output.data(), length) && sink->getFile().writeAt(output.data(), length, offset);
+            }
+
+            else if (!compressed && payloadSize == length)
+            {
+                written = socket->receiveToFile(sink->getFile(), offset, payloadSize);
+            }
+
+            if (!written || !sink->checkpoint(offset))
+            {
+                fail();
+
+                return;
+            }
+
+            hasher.push(offset);
+        }
+    };
+
+    if (channel)
+    {
+        sockets.push_back(channel);
+    }
+
+    threads.push_back(std::thread(receiveChunks, channel ? channel : control));
+
+    for (unsigned int i = 1; i < streams && !failed && !channel; i++)
+    {
+        TCPSocket* socket = listener->acceptConnection();
+
+        if (!socket)
+        {
+            fail();
+
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(sessionLock);
+
+            sockets.push_back(socket);
+        }
+
+        if (failed)
+        {
+            break;
+        }
+
+        const Message* join = socket->receive();
+
+        if (!join || join->data->getProperty("type")->asString() != "stream" || join->data->getProperty("ip")->asString() != ip || join->data->getProperty("id")->asString() != id)
+        {
+            fail();
+
+            delete join;
+
+            break;
+        }
+
+        delete join;
+
+        threads.push_back(std::thread(receiveChunks, socket));
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (TCPSocket* socket : sockets)
+    {
+        if (socket->isAlive())
+        {
+            socket->destroy();
+        }
+
+        delete socket;
+    }
+
+    if (!sink->flush() || failed || !chunks.isComplete() || !sink->isComplete() || !verifyHashes(control, hasher, sink))
+    {
+        return false;
+    }
+
+    const Message* response = new Message(new JSONObject(
+    {
+        { "type", new JSONString("received") }
+    }));
+
+    control->socketSend(response);
+
+    delete response;
+
+    return true;
+}
+
+bool NetworkManager::sendHashes(const TCPSocket* control, ChunkHasher& hasher)
+{
+    std::vector<uint64_t> hashes;
+
+    if (!hasher.finish(hashes))
+    {
+        errorHandler->handle(SquirrelFileException("Failed to hash file."));
+
+        return false;
+    }
+
+    const std::string data = ChunkHasher::encode(hashes);
+
+    const Message* message = new Message(new JSONObject(
+    {
+        { "type", new JSONString("hashes") },
+        { "root", new JSONString(std::to_string(HashTree::root(hashes))) }
+    }), 0, data.size());
+
+    const bool sent = control->sendMessage(message, data.data(), data.size());
+
+    delete message;
+
+    return sent;
+}
+
+bool NetworkManager::verifyHashes(const TCPSocket* control, ChunkHasher& hasher, ReceiveSink*& sink)
+{
+    const Message* message = control->receive();
+
+    if (!message)
+    {
+        return false;
+    }
+
+    const std::optional<std::string> type = message->data->getProperty("type")->asString();
+    const std::optional<uint64_t> root = message->data->getProperty("root")->asInteger();
+    const uint64_t payloadSize = message->payloadSize;
+
+    delete message;
+
+    std::vector<uint64_t> expected((sink->getSize() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+    if (type != "hashes" || !root || payloadSize != expected.size() * 8)
+    {
+        errorHandler->handle(SquirrelSocketException("Received incorrect message format."));
+
+        return false;
+    }
+
+    std::string data(payloadSize, '\0');
+
+    if (!control->receivePayload(data.data(), payloadSize))
+    {
+        return false;
+    }
+
+    std::vector<uint64_t> actual;
+
+    const bool hashed = hasher.finish(actual);
+
+    if (!ChunkHasher::decode(data, expected) || HashTree::root(expected) != root || (hashed && actual != expected))
+    {
+        errorHandler->handle(SquirrelFileException("File failed integrity check."));
+
+        sink->discard();
+
+        delete sink;
+
+        sink = nullptr;
+
+        return false;
+    }
+
+    if (!hashed)
+    {
+        errorHandler->handle(SquirrelFileException("Failed to hash file."));
+
+        return false;
+    }
+
+    return true;
+}
+
+bool NetworkManager::sendDelta(const TCPSocket* control, const ChunkReader& reader, const uint64_t blockSize, const uint64_t signatureSize)
+{
+    if (signatureSize > (uint64_t)DELTA_MAX_BLOCKS * DELTA_SIGNATURE_SIZE)
+    {
+        return false;
+    }
+
+    std::string data(signatureSize, '\0');
+
+    Signature signature;
+
+    if (!control->receivePayload(data.data(), data.size()) || blockSize > CHUNK_SIZE || !signature.decode(data, blockSize))
+    {
+        return false;
+    }
+
+    const DeltaEncoder encoder(signature);
+
+    const std::function<bool(const uint64_t, const char*, const uint64_t)> sendLiteral = [&](const uint64_t offset, const char* data, const uint64_t size)
+    {
+        const Message* message = new Message(new JSONObject(
+        {
+            { "type", new JSONString("literal") },
+            { "offset", new JSONString(std::to_string(offset)) }
+        }), 0, size);
+
+        const bool sent = control->sendMessage(message, data, size);
+
+        delete message;
+
+        return sent;
+    };
+
+    const std::function<bool(const uint64_t, const uint64_t, const uint64_t)> sendCopy = [&](const uint64_t offset, const uint64_t block, const uint64_t count)
+    {
+        const Message* message = new Message(new JSONObject(
+        {
+            { "type", new JSONString("copy") },
+            { "offset", new JSONString(std::to_string(offset)) },
+            { "block", new JSONString(std::to_string(block)) },
+            { "count", new JSONString(std::to_string(count)) }
+        }));
+
+        const bool sent = control->socketSend(message);
+
+        delete message;
+
+        return sent;
+    };
+
+    if (!encoder.encode(reader.getFile(), reader.getSize(), sendLiteral, sendCopy))
+    {
+        return false;
+    }
+
+    const Message* footer = new Message(new JSONObject(
+    {
+        { "type", new JSONString("complete") }
+    }));
+
+    const bool sent = control->socketSend(footer);
+
+    delete footer;
+
+    return sent;
+}
+
+bool NetworkManager::receiveDelta(const TCPSocket* control, const std::filesystem::path path, ReceiveSink* sink, ChunkHasher& hasher)
+{
+    File basis;
+
+    Signature signature;
+
+    if (!basis.openRead(path) || !signature.compute(basis, basis.getSize()))
+    {
+        return false;
+    }
+
+    const std::string data = signature.encode();
+
+    const Message* request = new Message(new JSONObject(
+    {
+        { "type", new JSONString("signature") },
+        { "block", new JSONString(std::to_string(signature.getBlockSize())) }
+    }), 0, data.size());
+
+    const bool sent = control->sendMessage(request, data.data(), data.size());
+
+    delete request;
+
+    if (!sent)
+    {
+        return false;
+    }
+
+    const uint64_t blockSize = signature.getBlockSize();
+    const uint64_t blockCount = signature.getBlocks().size();
+    const uint64_t size = sink->getSize();
+
+    std::vector<char> buffer(CHUNK_SIZE);
+
+    uint64_t position = 0;
+    uint64_t checkpointed = 0;
+
+    while (true)
+    {
+        const Message* message = control->receive();
+
+        if (!message)
+        {
+            return false;
+        }
+
+        const std::optional<std::string> type = message->data->getProperty("type")->asString();
+        const std::optional<uint64_t> offset = message->data->getProperty("offset")->asInteger();
+        const std::optional<uint64_t> block = message->data->getProperty("block")->asInteger();
+        const std::optional<uint64_t> count = message->data->getProperty("count")->asInteger();
+        const uint64_t payloadSize = message->payloadSize;
+
+        delete message;
+
+        if (type == "complete")
+        {
+            return position == size;
+        }
+
+        if (offset != position)
+        {
+            return false;
+        }
+
+        if (type == "literal")
+        {
+            if (payloadSize == 0 || payloadSize > size - position || !control->receiveToFile(sink->getFile(), position, payloadSize))
+            {
+                return false;
+            }
+
+            position += payloadSize;
+        }
+        else if (type == "copy")
+        {
+            if (!block || !count || count == 0 || block.value() >= blockCount || count.value() > blockCount - block.value() || count.value() * blockSize > size - position)
+            {
+                return false;
+            }
+
+            const uint64_t end = position + count.value() * blockSize;
+
+            for (uint64_t source = block.value() * blockSize; position < end;)
+            {
+                const uint64_t length = end - position < buffer.size() ? end - position : buffer.size();
+
+                if (!basis.readAt(buffer.data(), length, source) || !sink->getFile().writeAt(buffer.data(), length, position))
+                {
+                    return false;
+                }
+
+                source += length;
+                position += length;
+            }
+        }
+        else
+        {
+            return false;
+        }
+
+        for (; checkpointed < size && (checkpointed + CHUNK_SIZE <= position || position == size); checkpointed += CHUNK_SIZE)
+        {
+            if (!sink->checkpoint(checkpointed))
+            {
+                return false;
+            }
+
+            hasher.push(checkpointed);
+        }
+    }
+}
+
+bool NetworkManager::sendDeduplicated(const TCPSocket* control, const ChunkReader& reader)
+{
+    const ContentChunker chunker;
+
+    std::vector<StoredChunk> chunks;
+
+    if (!chunker.split(reader.getFile(), reader.getSize(), chunks))
+    {
+        return false;
+    }
+
+    const std::string data = ContentChunker::encode(chunks);
+
+    const Message* offer = new Message(new JSONObject(
+    {
+        { "type", new JSONString("offer") }
+    }), 0, data.size());
+
+    const bool sent = control->sendMessage(offer, data.data(), data.size());
+
+    delete offer;
+
+    const Message* reply = sent ? control->receive() : nullptr;
+
+    std::vector<bool> missing(chunks.size());
+
+    if (!reply || reply->data->getProperty("type")->asString() != "missing" || reply->payloadSize != (missing.size() + 7) / 8)
+    {
+        delete reply;
+
+        return false;
+    }
+
+    std::string bitmap(reply->payloadSize, '\0');
+
+    delete reply;
+
+    if (!control->receivePayload(bitmap.data(), bitmap.size()) || !ChunkMap::decode(bitmap, missing))
+    {
+        return false;
+    }
+
+    std::vector<char> buffer(STORE_MAX_CHUNK);
+
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        if (!missing[i])
+        {
+            continue;
+        }
+
+        ProtocolMessage message(MessageType::MessageData);
+
+        message.setInteger(MessageField::FieldIndex, i);
+
+        const bool sent = reader.getFile().readAt(buffer.data(), chunks[i].size, chunks[i].offset) && control->sendMessage(message, 0, buffer.data(), chunks[i].size);
+
+        if (!sent)
+        {
+            return false;
+        }
+    }
+
+    const Message* footer = new Message(new JSONObject(
+    {
+        { "type", new JSONString("complete") }
+    }));
+
+    const bool completed = control->socketSend(footer);
+
+    delete footer;
+
+    return completed;
+}
+
+bool NetworkManager::receiveDeduplicated(const TCPSocket* control, const std::filesystem::path directory, ReceiveSink* sink, ChunkHasher& hasher)
+{
+    ChunkStore store(directory);
+
+    if (!store.isOpen())
+    {
+        return false;
+    }
+
+    const Message* accept = new Message(new JSONObject(
+    {
+        { "type", new JSONString("store") }
+    }));
+
+    const bool sent = control->socketSend(accept);
+
+    delete accept;
+
+    const Message* offer = sent ? control->receive() : nullptr;
+
+    const uint64_t size = sink->getSize();
+
+    if (!offer || offer->data->getProperty("type")->asString() != "offer" || offer->payloadSize > (size / STORE_MIN_CHUNK + 1) * STORE_OFFER_SIZE)
+    {
+        delete offer;
+
+        return false;
+    }
+
+    std::string data(offer->payloadSize, '\0');
+
+    delete offer;
+
+    std::vector<StoredChunk> chunks;
+
+    if (!control->receivePayload(data.data(), data.size()) || !ContentChunker::decode(data, size, chunks))
+    {
+        return false;
+    }
+
+    std::vector<bool> missing(chunks.size());
+
+    std::unordered_set<std::string> requested;
+
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        missing[i] = !store.contains(chunks[i].hash) && requested.insert(chunks[i].hash).second;
+    }
+
+    const std::string bitmap = ChunkMap::encode(missing);
+
+    const Message* reply = new Message(new JSONObject(
+    {
+        { "type", new JSONString("missing") }
+    }), 0, bitmap.size());
+
+    const bool replied = control->sendMessage(reply, bitmap.data(), bitmap.size());
+
+    delete reply;
+
+    if (!replied)
+    {
+        return false;
+    }
+
+    std::vector<char> buffer(STORE_MAX_CHUNK);
+
+    std::string frame;
+
+    uint64_t checkpointed = 0;
+
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        if (missing[i])
+        {
+            FrameHeader frameHeader;
+
+            JSONView view;
+
+            ProtocolMessage message;
+
+            if (!control->receiveMessage(frame, frameHeader, view) || !ProtocolMessage::decode(view, message))
+            {
+                return false;
+            }
+
+            const uint64_t payloadSize = frameHeader.payloadLength;
+
+            if (message.type != MessageType::MessageData || message.getInteger(MessageField::FieldIndex) != i || payloadSize != chunks[i].size || !control->receivePayload(buffer.data(), payloadSize))
+            {
+                return false;
+            }
+
+            if (Sha256::digest(buffer.data(), payloadSize) != chunks[i].hash || !store.insert(chunks[i].hash, buffer.data(), payloadSize))
+            {
+                return false;
+            }
+        }
+
+        else if (!store.read(chunks[i].hash, buffer.data(), chunks[i].size))
+        {
+            return false;
+        }
+
+        if (!sink->getFile().writeAt(buffer.data(), chunks[i].size, chunks[i].offset))
+        {
+            return false;
+        }
+
+        const uint64_t position = chunks[i].offset + chunks[i].size;
+
+        for (; checkpointed < size && (checkpointed + CHUNK_SIZE <= position || position == size); checkpointed += CHUNK_SIZE)
+        {
+            if (!sink->checkpoint(checkpointed))
+            {
+                return false;
+            }
+
+            hasher.push(checkpointed);
+        }
+    }
+
+    const Message* footer = control->receive();
+
+    const bool complete = footer && footer->data->getProperty("type")->asString() == "complete";
+
+    delete footer;
+
+    return complete && store.flush();
+}
+
+MuxConnection::MuxConnection(TCPSocket* socket, Reactor* reactor, const bool initiator, const std::function<void(TCPSocket*)> handleStream) :
+    socket(socket), reactor(reactor), initiator(initiator), handleStream(handleStream)
+{
+    // Initiators open odd streams and acceptors even ones.
+
+    nextStream = initiator ? 1 : 2;
+
+    prefaced = initiator;
+    greeted = !initiator;
+
+    idleSince = std::chrono::steady_clock::now();
+}
+
+MuxConnection::~MuxConnection()
+{
+    if (socket->isAlive())
+    {
+        socket->destroy();
+    }
+
+    delete socket;
+}
+
+bool MuxConnection::start()
+{
+    const std::shared_ptr<MuxConnection> connection = shared_from_this();
+
+    if (!socket->setBlocking(false))
+    {
+        return false;
+    }
+
+    socket->setProfile(SocketProfile::SocketBulk);
+    socket->getTuning(tuning);
+
+    measuredSince = std::chrono::steady_clock::now();
+
+    if (!reactor->watch(socket->getHandle(), ReactorEvent::Readable, [connection](const unsigned int)
+    {
+        connection->receive();
+    }))
+    {
+        return false;
+    }
+
+    tuneTimer = reactor->addTimer(TUNE_INTERVAL, true, [connection]()
+    {
+        connection->tune();
+    });
+
+    return true;
+}
+
+void MuxConnection::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        failed = true;
+    }
+
+    signal.notify_all();
+
+    reactor->unwatch(socket->getHandle());
+    reactor->cancelTimer(tuneTimer);
+}
+
+TCPSocket* MuxConnection::open(TransferJob* job)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (failed)
+    {
+        return nullptr;
+    }
+
+    const uint32_t stream = nextStream;
+
+    nextStream += 2;
+
+    channels[stream] = MuxChannel();
+
+    return new MuxStream(shared_from_this(), stream, job);
+}
+
+bool MuxConnection::write(const uint32_t stream, const char* data, const uint64_t length)
+{
+    uint64_t sent = 0;
+
+    while (sent < length)
+    {
+        const uint64_t size = reserve(stream, length - sent);
+
+        if (size == 0 || !sendFrame(StreamHeader(StreamFrameType::StreamData, stream, size), data + sent))
+        {
+            return false;
+        }
+
+        sent += size;
+    }
+
+    return true;
+}
+
+bool MuxConnection::writeFile(const uint32_t stream, const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t length)
+{
+    uint64_t headerSent = 0;
+    uint64_t fileSent = 0;
+
+    while (headerSent < headerSize || fileSent < length)
+    {
+        const uint64_t size = reserve(stream, headerSize - headerSent + length - fileSent);
+
+        if (size == 0)
+        {
+            return false;
+        }
+
+        const uint64_t prefix = std::min(size, headerSize - headerSent);
+
+        if (!sendFileFrame(StreamHeader(StreamFrameType::StreamData, stream, size), header + headerSent, prefix, file, offset + fileSent, size - prefix))
+        {
+            return false;
+        }
+
+        headerSent += prefix;
+        fileSent += size - prefix;
+    }
+
+    return true;
+}
+
+bool MuxConnection::read(const uint32_t stream, char* buffer, const uint64_t length)
+{
+    uint64_t received = 0;
+
+    while (received < length)
+    {
+        uint64_t increment = 0;
+
+        {
+            std::unique_lock<std::mutex> guard(lock);
+
+            std::unordered_map<uint32_t, MuxChannel>::iterator channel;
+
+            signal.wait(guard, [&]()
+            {
+                channel = channels.find(stream);
+
+                return failed || channel == channels.end() || channel->second.ended || channel->second.position < channel->second.buffer.size();
+            });
+
+            if (channel == channels.end() || channel->second.position == channel->second.buffer.size())
+            {
+                return false;
+            }
+
+            MuxChannel& state = channel->second;
+
+            const uint64_t size = std::min((uint64_t)(state.buffer.size() - state.position), length - received);
+
+            memcpy(buffer + received, state.buffer.data() + state.position, size);
+
+            received += size;
+
+            state.position += size;
+            state.consumed += size;
+
+            if (state.position == state.buffer.size())
+            {
+                state.buffer.clear();
+
+                state.position = 0;
+            }
+
+            else if (state.position > state.buffer.size() / 2)
+            {
+                state.buffer.erase(0, state.position);
+
+                state.position = 0;
+            }
+
+            if (state.consumed >= STREAM_WINDOW / 2 && !state.ended)
+            {
+                increment = state.consumed;
+
+                state.consumed = 0;
+            }
+        }
+
+        if (increment > 0 && !sendFrame(StreamHeader(StreamFrameType::StreamWindow, stream, increment), nullptr))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool MuxConnection::readAvailable(const uint32_t stream, std::string& buffer)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    const std::unordered_map<uint32_t, MuxChannel>::iterator channel = channels.find(stream);
+
+    if (channel == channels.end())
+    {
+        return false;
+    }
+
+    buffer.append(channel->second.buffer, channel->second.position);
+
+    channel->second.buffer.clear();
+    channel->second.position = 0;
+
+    return !failed && !channel->second.ended;
+}
+
+void MuxConnection::close(const uint32_t stream)
+{
+    bool open = false;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        open = channels.erase(stream) > 0;
+
+        if (open && channels.empty())
+        {
+            idleSince = std::chrono::steady_clock::now();
+        }
+    }
+
+    signal.notify_all();
+
+    if (open)
+    {
+        sendFrame(StreamHeader(StreamFrameType::StreamClose, stream, 0), nullptr);
+    }
+}
+
+size_t MuxConnection::getStreamCount()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    return channels.size();
+}
+
+SocketTuning MuxConnection::getTuning()
+{
+    std::lock_guard<std::mutex> guard(tuneLock);
+
+    return tuning;
+}
+
+bool MuxConnection::isIdle(const unsigned int timeout)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    return channels.empty() && std::chrono::steady_clock::now() - idleSince >= std::chrono::milliseconds(timeout);
+}
+
+bool MuxConnection::isAlive() const
+{
+    return !failed;
+}
+
+void MuxConnection::receive()
+{
+    const size_t received = input.size();
+
+    const bool open = socket->receiveAvailable(input);
+
+    receivedBytes += input.size() - received;
+
+    size_t position = 0;
+
+    bool valid = true;
+
+    if (!prefaced && input.size() >= STREAM_PREFACE_SIZE)
+    {
+        valid = StreamHeader::decodePreface(input.data());
+
+        prefaced = true;
+
+        position = STREAM_PREFACE_SIZE;
+    }
+
+    while (valid && prefaced && input.size() - position >= STREAM_HEADER_SIZE)
+    {
+        StreamHeader header;
+
+        if (!StreamHeader::decode(input.data() + position, header))
+        {
+            valid = false;
+
+            break;
+        }
+
+        const uint64_t size = STREAM_HEADER_SIZE + (header.type == StreamFrameType::StreamData ? header.length : 0);
+
+        if (input.size() - position < size)
+        {
+            break;
+        }
+
+        valid = handleFrame(header, input.data() + position + STREAM_HEADER_SIZE);
+
+        position += size;
+    }
+
+    input.erase(0, position);
+
+    if (!open || !valid)
+    {
+        shutdown();
+    }
+}
+
+void MuxConnection::tune()
+{
+    const std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+
+    const double elapsed = std::chrono::duration<double>(now - measuredSince).count();
+
+    const uint64_t bytes = std::max(sentBytes.exchange(0), receivedBytes.exchange(0));
+
+    measuredSince = now;
+
+    SocketTuning current;
+
+    current.profile = SocketProfile::SocketBulk;
+
+    if (bytes == 0 || elapsed <= 0 || !socket->getTuning(current))
+    {
+        return;
+    }
+
+    const double throughput = bytes / elapsed;
+
+    if (current.roundTrip > 0)
+    {
+        const uint64_t target = std::clamp((uint64_t)(2 * throughput * current.roundTrip), (uint64_t)TUNE_MIN_BUFFER, (uint64_t)TUNE_MAX_BUFFER);
+
+        if ((target > current.sendBuffer || target > current.receiveBuffer) && socket->setBuffers(target, target))
+        {
+            socket->getTuning(current);
+        }
+    }
+
+    current.throughput = throughput;
+
+    {
+        std::lock_guard<std::mutex> guard(tuneLock);
+
+        tuning = current;
+    }
+
+    if (++tuneRounds >= TUNE_ROUNDS)
+    {
+        reactor->cancelTimer(tuneTimer);
+    }
+}
+
+bool MuxConnection::handleFrame(const StreamHeader& header, const char* data)
+{
+    bool accepted = false;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        std::unordered_map<uint32_t, MuxChannel>::iterator channel = channels.find(header.stream);
+
+        if (channel == channels.end())
+        {
+            const bool remote = (header.stream % 2 == 1) != initiator;
+
+            if (!remote || header.stream <= lastPeerStream || header.type != StreamFrameType::StreamData)
+            {
+                return true;
+            }
+
+            if (!handleStream)
+            {
+                return false;
+            }
+
+            lastPeerStream = header.stream;
+
+            channel = channels.emplace(header.stream, MuxChannel()).first;
+
+            accepted = true;
+        }
+
+        MuxChannel& state = channel->second;
+
+        if (header.type == StreamFrameType::StreamData)
+        {
+            if (state.buffer.size() - state.position + header.length > STREAM_WINDOW)
+            {
+                return false;
+            }
+
+            state.buffer.append(data, header.length);
+        }
+
+        else if (header.type == StreamFrameType::StreamWindow)
+        {
+            state.credit += header.length;
+        }
+
+        else
+        {
+            state.ended = true;
+        }
+    }
+
+    signal.notify_all();
+
+    if (accepted)
+    {
+        handleStream(new MuxStream(shared_from_this(), header.stream, nullptr));
+    }
+
+    return true;
+}
+
+uint64_t MuxConnection::reserve(const uint32_t stream, const uint64_t length)
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    std::unordered_map<uint32_t, MuxChannel>::iterator channel;
+
+    signal.wait(guard, [&]()
+    {
+        channel = channels.find(stream);
+
+        return failed || channel == channels.end() || channel->second.ended || channel->second.credit > 0;
+    });
+
+    if (failed || channel == channels.end() || channel->second.ended)
+    {
+        return 0;
+    }
+
+    const uint64_t size = std::min({ channel->second.credit, length, (uint64_t)STREAM_FRAME_SIZE });
+
+    channel->second.credit -= size;
+
+    return size;
+}
+
+void MuxConnection::encodeHeader(const StreamHeader& header)
+{
+    if (!greeted)
+    {
+        output.resize(STREAM_PREFACE_SIZE);
+
+        StreamHeader::encodePreface(output.data());
+
+        greeted = true;
+    }
+
+    const size_t start = output.size();
+
+    output.resize(start + STREAM_HEADER_SIZE);
+
+    header.encode(output.data() + start);
+}
+
+bool MuxConnection::sendFrame(const StreamHeader& header, const char* data)
+{
+    std::lock_guard<std::mutex> guard(writeLock);
+
+    if (failed)
+    {
+        return false;
+    }
+
+    encodeHeader(header);
+
+    const uint64_t length = header.type == StreamFrameType::StreamData ? header.length : 0;
+
+    const bool sent = socket->sendVectored(output.data(), output.size(), data, length);
+
+    sentBytes += output.size() + length;
+
+    output.clear();
+
+    return sent;
+}
+
+bool MuxConnection::sendFileFrame(const StreamHeader& header, const char* prefix, const uint64_t prefixSize, const File& file, const uint64_t offset, const uint64_t length)
+{
+    std::lock_guard<std::mutex> guard(writeLock);
+
+    if (failed)
+    {
+        return false;
+    }
+
+    encodeHeader(header);
+
+    output.append(prefix, prefixSize);
+
+    const bool sent = socket->sendFileRange(output.data(), output.size(), file, offset, length);
+
+    sentBytes += output.size() + length;
+
+    output.clear();
+
+    return sent;
+}
+
+MuxStream::MuxStream(const std::shared_ptr<MuxConnection> connection, const uint32_t stream, TransferJob* job) :
+    connection(connection), stream(stream), job(job) {}
+
+MuxStream::~MuxStream()
+{
+    if (open)
+    {
+        destroy();
+    }
+}
+
+bool MuxStream::create()
+{
+    return false;
+}
+
+bool MuxStream::socketBind(const std::string address, const unsigned int port) const
+{
+    return false;
+}
+
+bool MuxStream::socketConnect(const std::string address, const unsigned int port) const
+{
+    return false;
+}
+
+bool MuxStream::socketListen() const
+{
+    return false;
+}
+
+bool MuxStream::socketAccept()
+{
+    return false;
+}
+
+TCPSocket* MuxStream::acceptConnection() const
+{
+    return nullptr;
+}
+
+bool MuxStream::socketSend(const Message* message) const
+{
+    std::string& frame = getMessageBuffer();
+
+    encodeFrame(message, frame);
+
+    return sendPayload(frame.data(), frame.size());
+}
+
+bool MuxStream::sendPayload(const char* data, const uint64_t size) const
+{
+    if (!job)
+    {
+        return connection->write(stream, data, size);
+    }
+
+    const uint64_t quantum = job->isShaped() ? SHAPER_QUANTUM : size;
+
+    for (uint64_t written = 0; written < size;)
+    {
+        const uint64_t piece = std::min(size - written, quantum);
+
+        job->pace(piece);
+
+        if (!connection->write(stream, data + written, piece))
+        {
+            return false;
+        }
+
+        written += piece;
+
+        job->sent += piece;
+    }
+
+    return true;
+}
+
+bool MuxStream::sendVectored(const char* header, const uint64_t headerSize, const char* data, const uint64_t size) const
+{
+    return sendPayload(header, headerSize) && sendPayload(data, size);
+}
+
+bool MuxStream::sendFileRange(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const
+{
+    if (!job)
+    {
+        return connection->writeFile(stream, header, headerSize, file, offset, size);
+    }
+
+    const uint64_t quantum = job->isShaped() ? SHAPER_QUANTUM : size;
+
+    uint64_t prefix = headerSize;
+
+    for (uint64_t written = 0; written < size || prefix > 0;)
+    {
+        const uint64_t piece = std::min(size - written, quantum);
+
+        job->pace(prefix + piece);
+
+        if (!connection->writeFile(stream, header, prefix, file, offset + written, piece))
+        {
+            return false;
+        }
+
+        written += piece;
+
+        job->sent += prefix + piece;
+
+        prefix = 0;
+    }
+
+    return true;
+}
+
+bool MuxStream::receivePayload(char* buffer, const uint64_t size) const
+{
+    return connection->read(stream, buffer, size);
+}
+
+bool MuxStream::receiveToFile(const File& file, const uint64_t offset, const uint64_t size) const
+{
+    char buffer[FILE_BUFFER_SIZE];
+
+    uint64_t received = 0;
+
+    while (received < size)
+    {
+        const uint64_t length = size - received < FILE_BUFFER_SIZE ? size - received : FILE_BUFFER_SIZE;
+
+        if (!connection->read(stream, buffer, length) || !file.writeAt(buffer, length, offset + received))
+        {
+            return false;
+        }
+
+        received += length;
+    }
+
+    return true;
+}
+
+bool MuxStream::receiveAvailable(std::string& buffer) const
+{
+    return connection->readAvailable(stream, buffer);
+}
+
+SocketHandle MuxStream::getHandle() const
+{
+    return (SocketHandle)-1;
+}
+
+bool MuxStream::setBlocking(const bool blocking) const
+{
+    return blocking;
+}
+
+bool MuxStream::setProfile(const SocketProfile profile) const
+{
+    return false;
+}
+
+bool MuxStream::setBuffers(const uint64_t sendBuffer, const uint64_t receiveBuffer) const
+{
+    return false;
+}
+
+bool MuxStream::getTuning(SocketTuning& tuning) const
+{
+    tuning = connection->getTuning();
+
+    return true;
+}
+
+bool MuxStream::destroy()
+{
+    connection->close(stream);
+
+    open = false;
+
+    return true;
+}
+
+bool MuxStream::isAlive() const
+{
+    return open;
+}
+
+void MuxBacklog::track(const std::shared_ptr<MuxConnection> connection)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (closed)
+    {
+        connection->shutdown();
+
+        return;
+    }
+
+    connections.push_back(connection);
+}
+
+void MuxBacklog::push(TCPSocket* stream)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (!closed)
+        {
+            streams.push({ stream, std::chrono::steady_clock::now() });
+
+            stream = nullptr;
+        }
+    }
+
+    signal.notify_all();
+
+    delete stream;
+}
+
+TCPSocket* MuxBacklog::pop(const unsigned int timeout)
+{
+    std::vector<TCPSocket*> stale;
+
+    TCPSocket* stream = nullptr;
+
+    {
+        std::unique_lock<std::mutex> guard(lock);
+
+        signal.wait_for(guard, std::chrono::milliseconds(timeout), [&]()
+        {
+            return closed || !streams.empty();
+        });
+
+        stale.swap(expired);
+
+        if (!streams.empty())
+        {
+            stream = streams.front().stream;
+
+            streams.pop();
+        }
+    }
+
+    for (TCPSocket* expiredStream : stale)
+    {
+        delete expiredStream;
+    }
+
+    return stream;
+}
+
+void MuxBacklog::sweep(const unsigned int idleTimeout)
+{
+    std::vector<std::shared_ptr<MuxConnection>> closing;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        for (size_t i = 0; i < connections.size();)
+        {
+            if (!connections[i]->isAlive() || connections[i]->isIdle(idleTimeout))
+            {
+                closing.push_back(connections[i]);
+
+                connections.erase(connections.begin() + i);
+            }
+
+            else
+            {
+                i++;
+            }
+        }
+
+        // Closing a stream writes to its connection, which must not block the reactor thread.
+
+        const std::chrono::time_point<std::chrono::steady_clock> deadline = std::chrono::steady_clock::now() - std::chrono::milliseconds(ACCEPT_TIMEOUT);
+
+        while (!streams.empty() && streams.front().queued < deadline)
+        {
+            expired.push_back(streams.front().stream);
+
+            streams.pop();
+        }
+    }
+
+    for (const std::shared_ptr<MuxConnection>& connection : closing)
+    {
+        connection->shutdown();
+    }
+}
+
+void MuxBacklog::close()
+{
+    std::vector<std::shared_ptr<MuxConnection>> closing;
+    std::vector<TCPSocket*> pending;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        closed = true;
+
+        closing.swap(connections);
+        pending.swap(expired);
+
+        while (!streams.empty())
+        {
+            pending.push_back(streams.front().stream);
+
+            streams.pop();
+        }
+    }
+
+    signal.notify_all();
+
+    for (TCPSocket* stream : pending)
+    {
+        delete stream;
+    }
+
+    for (const std::shared_ptr<MuxConnection>& connection : closing)
+    {
+        connection->shutdown();
+    }
+}
+
+MuxListener::MuxListener(TCPSocket* socket, Reactor* reactor) :
+    socket(socket), reactor(reactor), backlog(std::make_shared<MuxBacklog>()) {}
+
+MuxListener::~MuxListener()
+{
+    delete socket;
+}
+
+bool MuxListener::create()
+{
+    return socket->create();
+}
+
+bool MuxListener::socketBind(const std::string address, const unsigned int port) const
+{
+    return socket->socketBind(address, port);
+}
+
+bool MuxListener::socketConnect(const std::string address, const unsigned int port) const
+{
+    return false;
+}
+
+bool MuxListener::socketListen() const
+{
+    if (!socket->socketListen() || !socket->setBlocking(false) || !reactor->watch(socket->getHandle(), ReactorEvent::Readable, [this](const unsigned int)
+    {
+        acceptConnections();
+    }))
+    {
+        return false;
+    }
+
+    const std::shared_ptr<MuxBacklog> backlog = this->backlog;
+
+    sweepTimer = reactor->addTimer(MUX_SWEEP_INTERVAL, true, [backlog]()
+    {
+        backlog->sweep(MUX_IDLE_TIMEOUT * 2);
+    });
+
+    return true;
+}
+
+bool MuxListener::socketAccept()
+{
+    return false;
+}
+
+TCPSocket* MuxListener::acceptConnection() const
+{
+    return backlog->pop(ACCEPT_TIMEOUT);
+}
+
+bool MuxListener::socketSend(const Message* message) const
+{
+    return false;
+}
+
+bool MuxListener::sendPayload(const char* data, const uint64_t size) const
+{
+    return false;
+}
+
+bool MuxListener::sendVectored(const char* header, const uint64_t headerSize, const char* data, const uint64_t size) const
+{
+    return false;
+}
+
+bool MuxListener::sendFileRange(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const
+{
+    return false;
+}
+
+bool MuxListener::receivePayload(char* buffer, const uint64_t size) const
+{
+    return false;
+}
+
+bool MuxListener::receiveToFile(const File& file, const uint64_t offset, const uint64_t size) const
+{
+    return false;
+}
+
+bool MuxListener::receiveAvailable(std::string& buffer) const
+{
+    return false;
+}
+
+SocketHandle MuxListener::getHandle() const
+{
+    return socket->getHandle();
+}
+
+bool MuxListener::setBlocking(const bool blocking) const
+{
+    return socket->setBlocking(blocking);
+}
+
+bool MuxListener::setProfile(const SocketProfile profile) const
+{
+    return socket->setProfile(profile);
+}
+
+bool MuxListener::setBuffers(const uint64_t sendBuffer, const uint64_t receiveBuffer) const
+{
+    return socket->setBuffers(sendBuffer, receiveBuffer);
+}
+
+bool MuxListener::getTuning(SocketTuning& tuning) const
+{
+    return socket->getTuning(tuning);
+}
+
+bool MuxListener::destroy()
+{
+    reactor->unwatch(socket->getHandle());
+    reactor->cancelTimer(sweepTimer);
+
+    reactor->synchronize();
+
+    backlog->close();
+
+    return socket->destroy();
+}
+
+bool MuxListener::isAlive() const
+{
+    return socket->isAlive();
+}
+
+void MuxListener::acceptConnections() const
+{
+    const std::shared_ptr<MuxBacklog> backlog = this->backlog;
+
+    while (TCPSocket* client = socket->acceptConnection())
+    {
+        const std::shared_ptr<MuxConnection> connection = std::make_shared<MuxConnection>(client, reactor, false, [backlog](TCPSocket* stream)
+        {
+            backlog->push(stream);
+        });
+
+        if (connection->start())
+        {
+            backlog->track(connection);
+        }
+    }
+}
+
+DatagramConnection::DatagramConnection(UDPSocket* socket, Reactor* reactor, const uint32_t token, const std::string address, const unsigned int port) :
+    socket(socket), reactor(reactor), token(token), address(address), port(port), passive(port == 0),
+    nextSend(std::chrono::steady_clock::now()), lastHeard(std::chrono::steady_clock::now()) {}
+
+DatagramConnection::~DatagramConnection()
+{
+    if (socket->isAlive())
+    {
+        socket->destroy();
+    }
+
+    delete socket;
+}
+
+bool DatagramConnection::start()
+{
+    const std::shared_ptr<DatagramConnection> connection = shared_from_this();
+
+    if (!socket->setBlocking(false) || !reactor->watch(socket->getHandle(), ReactorEvent::Readable, [connection](const unsigned int)
+    {
+        connection->receive();
+    }))
+    {
+        return false;
+    }
+
+    timer = reactor->addTimer(DATAGRAM_TICK, true, [connection]()
+    {
+        connection->tick();
+    });
+
+    return true;
+}
+
+void DatagramConnection::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        failed = true;
+    }
+
+    signal.notify_all();
+
+    reactor->unwatch(socket->getHandle());
+    reactor->cancelTimer(timer);
+}
+
+bool DatagramConnection::write(const char* data, const uint64_t length)
+{
+    return transmit(data, length);
+}
+
+bool DatagramConnection::read(char* buffer, const uint64_t length)
+{
+    uint64_t received = 0;
+
+    while (received < length)
+    {
+        bool update = false;
+
+        {
+            std::unique_lock<std::mutex> guard(lock);
+
+            signal.wait(guard, [&]()
+            {
+                return failed || ended || position < input.size();
+            });
+
+            if (position == input.size())
+            {
+                return false;
+            }
+
+            const uint64_t size = std::min((uint64_t)(input.size() - position), length - received);
+
+            memcpy(buffer + received, input.data() + position, size);
+
+            received += size;
+            position += size;
+
+            if (position == input.size())
+            {
+                input.clear();
+
+                position = 0;
+            }
+
+            else if (position > input.size() / 2)
+            {
+                input.erase(0, position);
+
+                position = 0;
+            }
+
+            update = advertised < DATAGRAM_WINDOW / 2 && getWindow() >= DATAGRAM_WINDOW / 2;
+        }
+
+        if (update)
+        {
+            sendAck();
+        }
+    }
+
+    return true;
+}
+
+bool DatagramConnection::readAvailable(std::string& buffer)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    buffer.append(input, position);
+
+    input.clear();
+
+    position = 0;
+
+    return !failed && !ended;
+}
+
+bool DatagramConnection::close()
+{
+    const bool delivered = transmit(nullptr, 0);
+
+    if (passive)
+    {
+        sendAck();
+    }
+
+    sendClose();
+    shutdown();
+
+    return delivered;
+}
+
+bool DatagramConnection::isAlive() const
+{
+    return !failed;
+}
+
+bool DatagramConnection::transmit(const char* data, const uint64_t length)
+{
+    char datagram[DATAGRAM_SIZE];
+
+    uint64_t written = 0;
+
+    while (true)
+    {
+        uint64_t size = 0;
+
+        {
+            std::unique_lock<std::mutex> guard(lock);
+
+            while (!lost.empty() && (packets.count(lost.front()) == 0 || !packets[lost.front()].lost))
+            {
+                lost.pop_front();
+            }
+
+            if (failed)
+            {
+                return false;
+            }
+
+            if (data ? written == length : packets.empty())
+            {
+                return true;
+            }
+
+            const bool resend = !lost.empty();
+            const bool fresh = !resend && data && inflight + DATAGRAM_PAYLOAD <= controller.getWindow() && nextSequence < peerAcknowledged + peerWindow;
+
+            if (!resend && !fresh)
+            {
+                if (data)
+                {
+                    controller.blocked();
+                }
+
+                signal.wait_for(guard, std::chrono::milliseconds(DATAGRAM_TICK));
+
+                continue;
+            }
+
+            const std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+
+            if (nextSend > now + std::chrono::microseconds(DATAGRAM_PACING_SLACK))
+            {
+                const std::chrono::time_point<std::chrono::steady_clock> due = nextSend;
+
+                controller.blocked();
+
+                guard.unlock();
+
+                std::this_thread::sleep_until(due);
+
+                continue;
+            }
+
+            uint64_t sequence = 0;
+
+            if (resend)
+            {
+                sequence = lost.front();
+
+                lost.pop_front();
+            }
+
+            else
+            {
+                if (packets.empty())
+                {
+                    lastHeard = now;
+                }
+
+                sequence = nextSequence++;
+
+                const uint64_t piece = std::min(length - written, (uint64_t)DATAGRAM_PAYLOAD);
+
+                packets[sequence].data.assign(data + written, piece);
+
+                written += piece;
+            }
+
+            DatagramPacket& packet = packets[sequence];
+
+            packet.lost = false;
+            packet.order = ++nextOrder;
+            packet.sent = now;
+
+            transmissions[packet.order] = sequence;
+
+            inflight += packet.data.size();
+
+            const uint64_t timestamp = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+
+            DatagramHeader(DatagramType::DatagramData, token, sequence, timestamp).encode(datagram);
+
+            memcpy(datagram + DATAGRAM_HEADER_SIZE, packet.data.data(), packet.data.size());
+
+            size = DATAGRAM_HEADER_SIZE + packet.data.size();
+
+            nextSend = std::max(nextSend, now - std::chrono::microseconds(DATAGRAM_PACING_SLACK)) + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(size / controller.getRate()));
+        }
+
+        socket->sendDatagram(datagram, size, address, port);
+    }
+}
+
+void DatagramConnection::receive()
+{
+    char datagram[DATAGRAM_SIZE];
+
+    std::string source;
+
+    unsigned int sourcePort = 0;
+
+    while (true)
+    {
+        const int64_t size = socket->receiveDatagram(datagram, DATAGRAM_SIZE, source, sourcePort);
+
+        if (size < 0)
+        {
+            break;
+        }
+
+        DatagramHeader header;
+
+        if (!DatagramHeader::decode(datagram, size, header) || header.token != token || source != address)
+        {
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+
+            if (port == 0)
+            {
+                port = sourcePort;
+            }
+
+            if (sourcePort != port)
+            {
+                continue;
+            }
+
+            lastHeard = std::chrono::steady_clock::now();
+        }
+
+        if (header.type == DatagramType::DatagramData)
+        {
+            handleData(header, datagram + DATAGRAM_HEADER_SIZE, size - DATAGRAM_HEADER_SIZE);
+        }
+
+        else if (header.type == DatagramType::DatagramAck)
+        {
+            SelectiveAck ack;
+
+            if (SelectiveAck::decode(datagram + DATAGRAM_HEADER_SIZE, size - DATAGRAM_HEADER_SIZE, header.sequence, ack))
+            {
+                handleAck(header, ack);
+            }
+        }
+
+        else
+        {
+            handleAck(header, SelectiveAck());
+            handleClose();
+        }
+    }
+}
+
+void DatagramConnection::tick()
+{
+    bool acknowledging = false;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (failed)
+        {
+            return;
+        }
+
+        const std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+
+        if (now - lastHeard > std::chrono::milliseconds(DATAGRAM_TIMEOUT) && ((passive && !ended) || !packets.empty()))
+        {
+            failed = true;
+        }
+
+        else if (!transmissions.empty() && now - packets[transmissions.begin()->second].sent > controller.getTimeout())
+        {
+            for (const std::pair<const uint64_t, uint64_t>& transmission : transmissions)
+            {
+                DatagramPacket& packet = packets[transmission.second];
+
+                packet.lost = true;
+
+                inflight -= packet.data.size();
+
+                lost.push_back(transmission.second);
+            }
+
+            transmissions.clear();
+
+            controller.timedOut();
+        }
+
+        acknowledging = !failed && (pendingAcks > 0 || (passive && getWindow() != advertised));
+    }
+
+    signal.notify_all();
+
+    if (acknowledging)
+    {
+        sendAck();
+    }
+}
+
+void DatagramConnection::handleData(const DatagramHeader& header, const char* data, const uint64_t size)
+{
+    bool acknowledging = false;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        echo = header.timestamp;
+
+        if (header.sequence < expected || header.sequence >= expected + DATAGRAM_WINDOW || received.count(header.sequence) > 0)
+        {
+            acknowledging = true;
+        }
+
+        else if (header.sequence == expected)
+        {
+            input.append(data, size);
+
+            expected++;
+
+            for (std::map<uint64_t, std::string>::iterator packet = received.begin(); packet != received.end() && packet->first == expected; packet = received.erase(packet))
+            {
+                input.append(packet->second);
+
+                expected++;
+            }
+
+            if (!runs.empty() && runs.begin()->first < expected)
+            {
+                runs.erase(runs.begin());
+            }
+        }
+
+        else
+        {
+            received[header.sequence].assign(data, size);
+
+            const std::map<uint64_t, uint64_t>::iterator next = runs.upper_bound(header.sequence);
+            const std::map<uint64_t, uint64_t>::iterator previous = next == runs.begin() ? runs.end() : std::prev(next);
+
+            const bool joinsPrevious = previous != runs.end() && previous->second == header.sequence;
+            const bool joinsNext = next != runs.end() && next->first == header.sequence + 1;
+
+            if (joinsPrevious && joinsNext)
+            {
+                previous->second = next->second;
+
+                runs.erase(next);
+            }
+
+            else if (joinsPrevious)
+            {
+                previous->second = header.sequence + 1;
+            }
+
+            else if (joinsNext)
+            {
+                const uint64_t end = next->second;
+
+                runs.erase(next);
+
+                runs[header.sequence] = end;
+            }
+
+            else
+            {
+                runs[header.sequence] = header.sequence + 1;
+            }
+        }
+
+        acknowledging = ++pendingAcks >= DATAGRAM_ACK_FREQUENCY || acknowledging;
+    }
+
+    signal.notify_all();
+
+    if (acknowledging)
+    {
+        sendAck();
+    }
+}
+
+void DatagramConnection::handleAck(const DatagramHeader& header, const SelectiveAck& ack)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (header.sequence > nextSequence)
+        {
+            return;
+        }
+
+        uint64_t acknowledged = 0;
+        uint64_t missing = 0;
+
+        const std::function<std::map<uint64_t, DatagramPacket>::iterator(const std::map<uint64_t, DatagramPacket>::iterator)> remove = [&](const std::map<uint64_t, DatagramPacket>::iterator packet)
+        {
+            if (!packet->second.lost)
+            {
+                transmissions.erase(packet->second.order);
+
+                inflight -= packet->second.data.size();
+
+                highestOrder = std::max(highestOrder, packet->second.order);
+            }
+
+            acknowledged += packet->second.data.size();
+
+            return packets.erase(packet);
+        };
+
+        peerAcknowledged = std::max(peerAcknowledged, header.sequence);
+        peerWindow = ack.window;
+
+        for (std::map<uint64_t, DatagramPacket>::iterator packet = packets.begin(); packet != packets.end() && packet->first < header.sequence;)
+        {
+            packet = remove(packet);
+        }
+
+        for (const std::pair<uint64_t, uint64_t>& range : ack.ranges)
+        {
+            for (std::map<uint64_t, DatagramPacket>::iterator packet = packets.lower_bound(range.first); packet != packets.end() && packet->first < range.second;)
+            {
+                packet = remove(packet);
+            }
+        }
+
+        while (!transmissions.empty() && transmissions.begin()->first + DATAGRAM_REORDER <= highestOrder)
+        {
+            DatagramPacket& packet = packets[transmissions.begin()->second];
+
+            packet.lost = true;
+
+            inflight -= packet.data.size();
+            missing += packet.data.size();
+
+            lost.push_back(transmissions.begin()->second);
+
+            transmissions.erase(transmissions.begin());
+        }
+
+        const uint64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        if (acknowledged > 0)
+        {
+            controller.acknowledged(acknowledged, header.timestamp > 0 && header.timestamp <= now ? (now - header.timestamp) / 1e6 : 0);
+        }
+
+        if (missing > 0)
+        {
+            controller.lost(missing);
+        }
+    }
+
+    signal.notify_all();
+}
+
+void DatagramConnection::handleClose()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        ended = true;
+
+        if (!packets.empty())
+        {
+            failed = true;
+        }
+    }
+
+    signal.notify_all();
+}
+
+void DatagramConnection::sendAck()
+{
+    char datagram[DATAGRAM_SIZE];
+
+    uint64_t size = 0;
+
+    unsigned int destination = 0;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (port == 0)
+        {
+            return;
+        }
+
+        SelectiveAck ack;
+
+        ack.window = getWindow();
+
+        ack.ranges.assign(runs.begin(), runs.end());
+
+        DatagramHeader(DatagramType::DatagramAck, token, expected, echo).encode(datagram);
+
+        size = DATAGRAM_HEADER_SIZE + ack.encode(datagram + DATAGRAM_HEADER_SIZE, expected);
+
+        advertised = ack.window;
+        pendingAcks = 0;
+
+        destination = port;
+    }
+
+    socket->sendDatagram(datagram, size, address, destination);
+}
+
+void DatagramConnection::sendClose()
+{
+    char datagram[DATAGRAM_HEADER_SIZE];
+
+    unsigned int destination = 0;
+
+    uint64_t sequence = 0;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        destination = port;
+        sequence = expected;
+    }
+
+    if (destination == 0)
+    {
         return;
     }
 
-    if (!transferSocket->socketListen())
-    {
-        errorHandler->handle(SquirrelSocketException("Failed to listen on socket."));
+    DatagramHeader(DatagramType::DatagramClose, token, sequence, 0).encode(datagram);
+
+    socket->sendDatagram(datagram, DATAGRAM_HEADER_SIZE, address, destination);
+}
+
+uint32_t DatagramConnection::getWindow() const
+{
+    const uint64_t unread = (input.size() - position) / DATAGRAM_PAYLOAD;
+
+    return unread >= DATAGRAM_WINDOW ? 0 : DATAGRAM_WINDOW - unread;
+}
+
+DatagramStream::DatagramStream(const std::shared_ptr<DatagramConnection> connection, TransferJob* job) :
+    connection(connection), job(job) {}
+
+DatagramStream::~DatagramStream()
+{
+    if (open)
+    {
+        destroy();
+    }
+}
+
+bool DatagramStream::create()
+{
+    return false;
+}
+
+bool DatagramStream::socketBind(const std::string address, const unsigned int port) const
+{
+    return false;
+}
+
+bool DatagramStream::socketConnect(const std::string address, const unsigned int port) const
+{
+    return false;
+}
+
+bool DatagramStream::socketListen() const
+{
+    return false;
+}
+
+bool DatagramStream::socketAccept()
+{
+    return false;
+}
+
+TCPSocket* DatagramStream::acceptConnection() const
+{
+    return nullptr;
+}
+
+bool DatagramStream::socketSend(const Message* message) const
+{
+    std::string& frame = getMessageBuffer();
+
+    encodeFrame(message, frame);
+
+    return sendPayload(frame.data(), frame.size());
+}
+
+bool DatagramStream::sendPayload(const char* data, const uint64_t size) const
+{
+    if (!job)
+    {
+        return connection->write(data, size);
+    }
+
+    const uint64_t quantum = job->isShaped() ? SHAPER_QUANTUM : size;
+
+    for (uint64_t written = 0; written < size;)
+    {
+        const uint64_t piece = std::min(size - written, quantum);
+
+        job->pace(piece);
+
+        if (!connection->write(data + written, piece))
+        {
+            return false;
+        }
+
+        written += piece;
+
+        job->sent += piece;
+    }
+
+    return true;
+}
+
+bool DatagramStream::sendVectored(const char* header, const uint64_t headerSize, const char* data, const uint64_t size) const
+{
+    return sendPayload(header, headerSize) && sendPayload(data, size);
+}
+
+bool DatagramStream::sendFileRange(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const
+{
+    if (!sendPayload(header, headerSize))
+    {
+        return false;
+    }
+
+    char buffer[FILE_BUFFER_SIZE];
+
+    uint64_t sent = 0;
+
+    while (sent < size)
+    {
+        const uint64_t length = size - sent < FILE_BUFFER_SIZE ? size - sent : FILE_BUFFER_SIZE;
+
+        if (!file.readAt(buffer, length, offset + sent) || !sendPayload(buffer, length))
+        {
+            return false;
+        }
+
+        sent += length;
+    }
+
+    return true;
+}
+
+bool DatagramStream::receivePayload(char* buffer, const uint64_t size) const
+{
+    return connection->read(buffer, size);
+}
+
+bool DatagramStream::receiveToFile(const File& file, const uint64_t offset, const uint64_t size) const
+{
+    char buffer[FILE_BUFFER_SIZE];
+
+    uint64_t received = 0;
+
+    while (received < size)
+    {
+        const uint64_t length = size - received < FILE_BUFFER_SIZE ? size - received : FILE_BUFFER_SIZE;
+
+        if (!connection->read(buffer, length) || !file.writeAt(buffer, length, offset + received))
+        {
+            return false;
+        }
+
+        received += length;
+    }
+
+    return true;
+}
+
+bool DatagramStream::receiveAvailable(std::string& buffer) const
+{
+    return connection->readAvailable(buffer);
+}
+
+SocketHandle DatagramStream::getHandle() const
+{
+    return (SocketHandle)-1;
+}
+
+bool DatagramStream::setBlocking(const bool blocking) const
+{
+    return blocking;
+}
+
+bool DatagramStream::setProfile(const SocketProfile profile) const
+{
+    return false;
+}
+
+bool DatagramStream::setBuffers(const uint64_t sendBuffer, const uint64_t receiveBuffer) const
+{
+    return false;
+}
+
+bool DatagramStream::getTuning(SocketTuning& tuning) const
+{
+    return false;
+}
+
+bool DatagramStream::destroy()
+{
+    open = false;
+
+    return connection->close();
+}
+
+bool DatagramStream::isAlive() const
+{
+    return open;
+}
+
+ImpairedUDPSocket::ImpairedUDPSocket(UDPSocket* socket, const unsigned int loss, const unsigned int latency) :
+    socket(socket), loss(loss), latency(latency), generator(std::random_device()())
+{
+    if (latency > 0)
+    {
+        thread = std::thread(&ImpairedUDPSocket::deliver, this);
+    }
+}
+
+ImpairedUDPSocket::~ImpairedUDPSocket()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        stopping = true;
+    }
+
+    signal.notify_all();
+
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+
+    delete socket;
+}
+
+bool ImpairedUDPSocket::create(const std::string address)
+{
+    return socket->create(address);
+}
+
+bool ImpairedUDPSocket::socketBind(const std::string address, const unsigned int port) const
+{
+    return socket->socketBind(address, port);
+}
+
+bool ImpairedUDPSocket::socketSend(const Message* message, const std::string address, const unsigned int port) const
+{
+    return socket->socketSend(message, address, port);
+}
+
+bool ImpairedUDPSocket::sendDatagram(const char* data, const uint64_t size, const std::string address, const unsigned int port) const
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (stopping)
+        {
+            return false;
+        }
+
+        if (generator() % 100 < loss)
+        {
+            return true;
+        }
+
+        if (latency > 0)
+        {
+            delayed.push_back({ std::chrono::steady_clock::now() + std::chrono::milliseconds(latency), std::string(data, size), address, port });
+
+            signal.notify_all();
+
+            return true;
+        }
+    }
+
+    return socket->sendDatagram(data, size, address, port);
+}
+
+Message* ImpairedUDPSocket::receive() const
+{
+    return socket->receive();
+}
+
+int64_t ImpairedUDPSocket::receiveDatagram(char* buffer, const uint64_t size, std::string& address, unsigned int& port) const
+{
+    return socket->receiveDatagram(buffer, size, address, port);
+}
+
+SocketHandle ImpairedUDPSocket::getHandle() const
+{
+    return socket->getHandle();
+}
+
+unsigned int ImpairedUDPSocket::getPort() const
+{
+    return socket->getPort();
+}
+
+bool ImpairedUDPSocket::setBlocking(const bool blocking) const
+{
+    return socket->setBlocking(blocking);
+}
+
+bool ImpairedUDPSocket::destroy()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        stopping = true;
+    }
+
+    signal.notify_all();
+
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+
+    return socket->destroy();
+}
+
+bool ImpairedUDPSocket::isAlive() const
+{
+    return socket->isAlive();
+}
+
+void ImpairedUDPSocket::deliver()
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    while (!stopping || !delayed.empty())
+    {
+        if (delayed.empty())
+        {
+            signal.wait(guard);
+
+            continue;
+        }
+
+        const std::chrono::time_point<std::chrono::steady_clock> due = delayed.front().due;
+
+        if (due > std::chrono::steady_clock::now())
+        {
+            signal.wait_until(guard, due);
+
+            continue;
+        }
+
+        const DelayedDatagram datagram = delayed.front();
+
+        delayed.pop_front();
+
+        guard.unlock();
+
+        socket->sendDatagram(datagram.data.data(), datagram.data.size(), datagram.address, datagram.port);
+
+        guard.lock();
+    }
+}
+
+#ifdef _WIN32
+
+bool WinUDPSocket::create(const std::string address)
+{
+    socketHandle = socket(PF_INET, SOCK_DGRAM, 0);
+
+    if (socketHandle == INVALID_SOCKET)
+    {
+        return false;
+    }
+
+    bool val = true;
+
+    if (setsockopt(socketHandle, SOL_SOCKET, SO_BROADCAST, (char*)&val, sizeof(bool)) == SOCKET_ERROR)
+    {
+        return false;
+    }
+
+    unsigned long addr = inet_addr(address.c_str());
+
+    return setsockopt(socketHandle, IPPROTO_IP, IP_UNICAST_IF, (char*)&addr, sizeof(addr)) != SOCKET_ERROR;
+}
+
+bool WinUDPSocket::socketBind(const std::string address, const unsigned int port) const
+{
+    sockaddr_in addr;
+
+    memset(&addr, 0, sizeof(addr));
+
+    addr.sin_family = AF_INET;
+    addr.sin_port = port;
+    addr.sin_addr.s_addr = inet_addr(address.c_str());
+
+    return bind(socketHandle, (sockaddr*)&addr, sizeof(addr)) != SOCKET_ERROR;
+}
+
+bool WinUDPSocket::socketSend(const Message* message, const std::string address, const unsigned int port) const
+{
+    sockaddr_in addr;
+
+    memset(&addr, 0, sizeof(addr));
+
+    addr.sin_family = AF_INET;
+    addr.sin_port = port;
+    addr.sin_addr.s_addr = inet_addr(address.c_str());
+
+    std::string& datagram = getMessageBuffer();
+
+    if (!encodeDatagram(message, datagram))
+    {
+        return false;
+    }
+
+    return sendto(socketHandle, datagram.data(), (int)datagram.size(), 0, (sockaddr*)&addr, sizeof(addr)) == (int)datagram.size();
+}
+
+bool WinUDPSocket::sendDatagram(const char* data, const uint64_t size, const std::string address, const unsigned int port) const
+{
+    sockaddr_in addr;
+
+    memset(&addr, 0, sizeof(addr));
+
+    addr.sin_family = AF_INET;
+    addr.sin_port = port;
+    addr.sin_addr.s_addr = inet_addr(address.c_str());
+
+    return sendto(socketHandle, data, (int)size, 0, (sockaddr*)&addr, sizeof(addr)) == (int)size;
+}
+
+Message* WinUDPSocket::receive() const
+{
+    char buffer[BUFFER_SIZE];
+
+    const int received = recv(socketHandle, buffer, BUFFER_SIZE, 0);
+
+    if (received == -1)
+    {
+        return nullptr;
+    }
+
+    return Message::deserialize(std::string_view(buffer, received));
+}
+
+int64_t WinUDPSocket::receiveDatagram(char* buffer, const uint64_t size, std::string& address, unsigned int& port) const
+{
+    sockaddr_in addr;
+
+    int length = sizeof(addr);
+
+    const int received = recvfrom(socketHandle, buffer, (int)size, 0, (sockaddr*)&addr, &length);
+
+    if (received == SOCKET_ERROR)
+    {
+        return -1;
+    }
+
+    char text[INET_ADDRSTRLEN];
+
+    inet_ntop(AF_INET, &addr.sin_addr, text, sizeof(text));
+
+    address = text;
+    port = addr.sin_port;
+
+    return received;
+}
+
+SocketHandle WinUDPSocket::getHandle() const
+{
+    return socketHandle;
+}
+
+unsigned int WinUDPSocket::getPort() const
+{
+    sockaddr_in addr;
+
+    int length = sizeof(addr);
+
+    if (getsockname(socketHandle, (sockaddr*)&addr, &length) == SOCKET_ERROR)
+    {
+        return 0;
+    }
+
+    return addr.sin_port;
+}
+
+bool WinUDPSocket::setBlocking(const bool blocking) const
+{
+    u_long mode = blocking ? 0 : 1;
+
+    return ioctlsocket(socketHandle, FIONBIO, &mode) == 0;
+}
+
+bool WinUDPSocket::destroy()
+{
+    if (shutdown(socketHandle, SD_BOTH) == SOCKET_ERROR)
+    {
+        return false;
+    }
+
+    if (closesocket(socketHandle) == SOCKET_ERROR)
+    {
+        return false;
+    }
+
+    socketHandle = INVALID_SOCKET;
+
+    return true;
+}
+
+bool WinUDPSocket::isAlive() const
+{
+    return socketHandle != INVALID_SOCKET;
+}
+
+WinTCPSocket::WinTCPSocket() {}
+
+WinTCPSocket::WinTCPSocket(const SOCKET socketHandle) :
+    socketHandle(socketHandle) {}
+
+bool WinTCPSocket::create()
+{
+    socketHandle = socket(PF_INET, SOCK_STREAM, 0);
+
+    return socketHandle != INVALID_SOCKET;
+}
+
+bool WinTCPSocket::socketBind(const std::string address, const unsigned int port) const
+{
+    sockaddr_in addr;
+
+    memset(&addr, 0, sizeof(addr));
+
+    addr.sin_family = AF_INET;
+    addr.sin_port = port;
+    addr.sin_addr.s_addr = inet_addr(address.c_str());
+
+    return bind(socketHandle, (sockaddr*)&addr, sizeof(addr)) != SOCKET_ERROR;
+}
+
+bool WinTCPSocket::socketConnect(const std::string address, const unsigned int port) const
+{
+    sockaddr_in addr;
+
+    memset(&addr, 0, sizeof(addr));
+
+    addr.sin_family = AF_INET;
+    addr.sin_port = port;
+    addr.sin_addr.s_addr = inet_addr(address.c_str());
+
+    return connect(socketHandle, (sockaddr*)&addr, sizeof(addr)) != SOCKET_ERROR;
+}
+
+bool WinTCPSocket::socketListen() const
+{
+    return listen(socketHandle, LISTEN_BACKLOG) != SOCKET_ERROR;
+}
+
+bool WinTCPSocket::socketAccept()
+{
+    SOCKET clientHandle = accept(socketHandle, nullptr, nullptr);
+
+    if (clientHandle == INVALID_SOCKET)
+    {
+        return false;
+    }
+
+    if (closesocket(socketHandle) == SOCKET_ERROR)
+    {
+        return false;
+    }
+
+    socketHandle = clientHandle;
+
+    return true;
+}
+
+TCPSocket* WinTCPSocket::acceptConnection() const
+{
+    SOCKET clientHandle = accept(socketHandle, nullptr, nullptr);
+
+    if (clientHandle == INVALID_SOCKET)
+    {
+        return nullptr;
+    }
+
+    return new WinTCPSocket(clientHandle);
+}
+
+bool WinTCPSocket::socketSend(const Message* message) const
+{
+    std::string& frame = getMessageBuffer();
+
+    encodeFrame(message, frame);
+
+    return sendAll(frame.data(), frame.size());
+}
+
+bool WinTCPSocket::sendPayload(const char* data, const uint64_t size) const
+{
+    return sendAll(data, size);
+}
+
+bool WinTCPSocket::sendVectored(const char* header, const uint64_t headerSize, const char* data, const uint64_t size) const
+{
+    if (headerSize > ULONG_MAX || size > ULONG_MAX)
+    {
+        return sendAll(header, headerSize) && sendAll(data, size);
+    }
+
+    WSABUF buffers[2] = { { (ULONG)headerSize, (CHAR*)header }, { (ULONG)size, (CHAR*)data } };
+
+    unsigned int first = 0;
+
+    while (first < 2)
+    {
+        if (buffers[first].len == 0)
+        {
+            first++;
+
+            continue;
+        }
+
+        DWORD sent = 0;
+
+        if (WSASend(socketHandle, buffers + first, 2 - first, &sent, 0, nullptr, nullptr) == SOCKET_ERROR)
+        {
+            if (WSAGetLastError() != WSAEWOULDBLOCK)
+            {
+                return false;
+            }
+
+            WSAPOLLFD handle = { socketHandle, POLLWRNORM, 0 };
+
+            WSAPoll(&handle, 1, -1);
+
+            continue;
+        }
+
+        if (sent == 0)
+        {
+            return false;
+        }
+
+        while (first < 2 && sent >= buffers[first].len)
+        {
+            sent -= buffers[first].len;
+
+            first++;
+        }
+
+        if (first < 2)
+        {
+            buffers[first].buf += sent;
+            buffers[first].len -= sent;
+        }
+    }
+
+    return true;
+}
+
+bool WinTCPSocket::sendFileRange(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const
+{
+    if (size == 0)
+    {
+        return sendAll(header, headerSize);
+    }
+
+    char buffer[FILE_BUFFER_SIZE];
+
+    uint64_t sent = 0;
+
+    while (sent < size)
+    {
+        const uint64_t length = size - sent < FILE_BUFFER_SIZE ? size - sent : FILE_BUFFER_SIZE;
+
+        if (!file.readAt(buffer, length, offset + sent) || !sendVectored(header, sent == 0 ? headerSize : 0, buffer, length))
+        {
+            return false;
+        }
+
+        sent += length;
+    }
+
+    return true;
+}
+
+bool WinTCPSocket::receivePayload(char* buffer, const uint64_t size) const
+{
+    return receiveAll(buffer, size);
+}
+
+bool WinTCPSocket::receiveToFile(const File& file, const uint64_t offset, const uint64_t size) const
+{
+    char buffer[FILE_BUFFER_SIZE];
+
+    uint64_t received = 0;
+
+    while (received < size)
+    {
+        const uint64_t length = size - received < FILE_BUFFER_SIZE ? size - received : FILE_BUFFER_SIZE;
+
+        if (!receiveAll(buffer, length) || !file.writeAt(buffer, length, offset + received))
+        {
+            return false;
+        }
+
+        received += length;
+    }
+
+    return true;
+}
+
+bool WinTCPSocket::sendAll(const char* data, const uint64_t length) const
+{
+    uint64_t sent = 0;
+
+    while (sent < length)
+    {
+        const int request = length - sent < INT_MAX ? (int)(length - sent) : INT_MAX;
+        const int result = send(socketHandle, data + sent, request, 0);
+
+        if (result == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK)
+        {
+            WSAPOLLFD handle = { socketHandle, POLLWRNORM, 0 };
+
+            WSAPoll(&handle, 1, -1);
+
+            continue;
+        }
+
+        if (result <= 0)
+        {
+            return false;
+        }
+
+        sent += result;
+    }
+
+    return true;
+}
+
+bool WinTCPSocket::receiveAll(char* buffer, const uint64_t length) const
+{
+    uint64_t received = 0;
+
+    while (received < length)
+    {
+        const int request = length - received < INT_MAX ? (int)(length - received) : INT_MAX;
+        const int result = recv(socketHandle, buffer + received, request, 0);
+
+        if (result <= 0)
+        {
+            return false;
+        }
+
+        received += result;
+    }
+
+    return true;
+}
+
+bool WinTCPSocket::receiveAvailable(std::string& buffer) const
+{
+    char data[FILE_BUFFER_SIZE];
+
+    while (true)
+    {
+        const int result = recv(socketHandle, data, FILE_BUFFER_SIZE, 0);
+
+        if (result == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK)
+        {
+            return true;
+        }
+
+        if (result <= 0)
+        {
+            return false;
+        }
+
+        buffer.append(data, result);
+    }
+}
+
+SocketHandle WinTCPSocket::getHandle() const
+{
+    return socketHandle;
+}
+
+bool WinTCPSocket::setBlocking(const bool blocking) const
+{
+    u_long mode = blocking ? 0 : 1;
+
+    return ioctlsocket(socketHandle, FIONBIO, &mode) == 0;
+}
+
+bool WinTCPSocket::setProfile(const SocketProfile profile) const
+{
+    const BOOL enabled = TRUE;
+
+    return setsockopt(socketHandle, IPPROTO_TCP, TCP_NODELAY, (const char*)&enabled, sizeof(enabled)) == 0;
+}
+
+bool WinTCPSocket::setBuffers(const uint64_t sendBuffer, const uint64_t receiveBuffer) const
+{
+    const int sendSize = std::min(sendBuffer, (uint64_t)TUNE_MAX_BUFFER);
+    const int receiveSize = std::min(receiveBuffer, (uint64_t)TUNE_MAX_BUFFER);
+
+    return setsockopt(socketHandle, SOL_SOCKET, SO_SNDBUF, (const char*)&sendSize, sizeof(sendSize)) == 0
+        && setsockopt(socketHandle, SOL_SOCKET, SO_RCVBUF, (const char*)&receiveSize, sizeof(receiveSize)) == 0;
+}
+
+bool WinTCPSocket::getTuning(SocketTuning& tuning) const
+{
+    int sendSize = 0;
+    int receiveSize = 0;
+
+    BOOL noDelay = FALSE;
+
+    int length = sizeof(sendSize);
+
+    if (getsockopt(socketHandle, SOL_SOCKET, SO_SNDBUF, (char*)&sendSize, &length) != 0)
+    {
+        return false;
+    }
+
+    length = sizeof(receiveSize);
+
+    if (getsockopt(socketHandle, SOL_SOCKET, SO_RCVBUF, (char*)&receiveSize, &length) != 0)
+    {
+        return false;
+    }
+
+    length = sizeof(noDelay);
+
+    if (getsockopt(socketHandle, IPPROTO_TCP, TCP_NODELAY, (char*)&noDelay, &length) != 0)
+    {
+        return false;
+    }
+
+    tuning.sendBuffer = sendSize;
+    tuning.receiveBuffer = receiveSize;
+    tuning.noDelay = noDelay;
+
+    return true;
+}
+
+bool WinTCPSocket::destroy()
+{
+    if (shutdown(socketHandle, SD_BOTH) == SOCKET_ERROR && WSAGetLastError() != WSAENOTCONN)
+    {
+        return false;
+    }
+
+    if (closesocket(socketHandle) == SOCKET_ERROR)
+    {
+        return false;
+    }
+
+    socketHandle = INVALID_SOCKET;
+
+    return true;
+}
+
+bool WinTCPSocket::isAlive() const
+{
+    return socketHandle != INVALID_SOCKET;
+}
+
+WinNetworkManager::WinNetworkManager(ErrorHandler* errorHandler) :
+    NetworkManager(errorHandler, getName(), getAddress())
+{
+    WSADATA wsaData;
+
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+    {
+        errorHandler->handle(SquirrelSocketException("Failed to initialize WinSock."));
+    }
+}
+
+WinNetworkManager::~WinNetworkManager()
+{
+    WSACleanup();
+}
+
+unsigned int WinNetworkManager::convertAddress(const std::string address) const
+{
+    return inet_addr(address.c_str());
+}
+
+std::string WinNetworkManager::convertAddress(const unsigned int address) const
+{
+    in_addr addr;
+
+    addr.s_addr = address;
+
+    return inet_ntoa(addr);
+}
+
+UDPSocket* WinNetworkManager::newUDPSocket() const
+{
+    return new WinUDPSocket();
+}
+
+TCPSocket* WinNetworkManager::newTCPSocket() const
+{
+    return new WinTCPSocket();
+}
+
+std::string WinNetworkManager::getName() const
+{
+    char buffer[UNLEN + 1];
+
+    unsigned long size = UNLEN + 1;
+
+    if (!GetUserName(buffer, &size))
+    {
+        return "";
+    }
+
+    return buffer;
+}
+
+std::string WinNetworkManager::getAddress() const
+{
+    unsigned long size = sizeof(IP_ADAPTER_ADDRESSES) * 32;
+
+    IP_ADAPTER_ADDRESSES* addrs = (IP_ADAPTER_ADDRESSES*)malloc(size);
+
+    if (GetAdaptersAddresses(AF_INET, 0, nullptr, addrs, &size) != NO_ERROR)
+    {
+        free(addrs);
+
+        return "";
+    }
+
+    IP_ADAPTER_ADDRESSES* head = addrs;
+
+    while (addrs)
+    {
+        NL_NETWORK_CONNECTIVITY_HINT hint;
+
+        if (GetNetworkConnectivityHintForInterface(addrs->IfIndex, &hint) == NO_ERROR && hint.ConnectivityLevel == NetworkConnectivityLevelHintInternetAccess)
+        {
+            if (addrs->IfType != IF_TYPE_SOFTWARE_LOOPBACK && addrs->OperStatus == IfOperStatusUp)
+            {
+                break;
+            }
+        }
+
+        addrs = addrs->Next;
+    }
+
+    if (!addrs)
+    {
+        free(head);
+
+        return "";
+    }
+
+    char* address = inet_ntoa(((sockaddr_in*)addrs->FirstUnicastAddress->Address.lpSockaddr)->sin_addr);
+
+    free(head);
+
+    return address;
+}
+
+#else
+
+static void advanceVectors(iovec*& vectors, int& count, size_t sent)
+{
+    while (count > 0 && sent >= vectors->iov_len)
+    {
+        sent -= vectors->iov_len;
+
+        vectors++;
+        count--;
+    }
+
+    if (count > 0)
+    {
+        vectors->iov_base = (char*)vectors->iov_base + sent;
+        vectors->iov_len -= sent;
+    }
+}
+
+bool BSDUDPSocket::create(const std::string address)
+{
+    socketHandle = socket(PF_INET, SOCK_DGRAM, 0);
+
+    if (socketHandle == -1)
+    {
+        return false;
+    }
+
+    int val = 1;
+
+    if (setsockopt(socketHandle, SOL_SOCKET, SO_BROADCAST, &val, sizeof(val)) == -1)
+    {
+        return false;
+    }
+
+    ip_mreq req;
+
+    req.imr_interface.s_addr = inet_addr(address.c_str());
+    req.imr_multiaddr.s_addr = inet_addr(address.c_str());
+
+    return setsockopt(socketHandle, IPPROTO_IP, IP_MULTICAST_IF, &req, sizeof(req)) != -1;
+}
+
+bool BSDUDPSocket::socketBind(const std::string address, const unsigned int port) const
+{
+    sockaddr_in addr;
+
+    memset(&addr, 0, sizeof(addr));
+
+    addr.sin_family = AF_INET;
+    addr.sin_port = port;
+    addr.sin_addr.s_addr = inet_addr(address.c_str());
+
+    return bind(socketHandle, (sockaddr*)&addr, sizeof(addr)) == 0;
+}
+
+bool BSDUDPSocket::socketSend(const Message* message, const std::string address, const unsigned int port) const
+{
+    sockaddr_in addr;
+
+    memset(&addr, 0, sizeof(addr));
+
+    addr.sin_family = AF_INET;
+    addr.sin_port = port;
+    addr.sin_addr.s_addr = inet_addr(address.c_str());
+
+    std::string& datagram = getMessageBuffer();
+
+    if (!encodeDatagram(message, datagram))
+    {
+        return false;
+    }
+
+    return sendto(socketHandle, datagram.data(), datagram.size(), 0, (sockaddr*)&addr, sizeof(addr)) == (ssize_t)datagram.size();
+}
+
+bool BSDUDPSocket::sendDatagram(const char* data, const uint64_t size, const std::string address, const unsigned int port) const
+{
+    sockaddr_in addr;
+
+    memset(&addr, 0, sizeof(addr));
+
+    addr.sin_family = AF_INET;
+    addr.sin_port = port;
+    addr.sin_addr.s_addr = inet_addr(address.c_str());
+
+    return sendto(socketHandle, data, size, 0, (sockaddr*)&addr, sizeof(addr)) == (ssize_t)size;
+}
+
+Message* BSDUDPSocket::receive() const
+{
+    char buffer[BUFFER_SIZE];
+
+    const ssize_t received = recv(socketHandle, buffer, BUFFER_SIZE, 0);
+
+    if (received == -1)
+    {
+        return nullptr;
+    }
+
+    return Message::deserialize(std::string_view(buffer, received));
+}
+
+int64_t BSDUDPSocket::receiveDatagram(char* buffer, const uint64_t size, std::string& address, unsigned int& port) const
+{
+    sockaddr_in addr;
+
+    socklen_t length = sizeof(addr);
+
+    const ssize_t received = recvfrom(socketHandle, buffer, size, 0, (sockaddr*)&addr, &length);
+
+    if (received == -1)
+    {
+        return -1;
+    }
+
+    char text[INET_ADDRSTRLEN];
+
+    inet_ntop(AF_INET, &addr.sin_addr, text, sizeof(text));
+
+    address = text;
+    port = addr.sin_port;
+
+    return received;
+}
+
+SocketHandle BSDUDPSocket::getHandle() const
+{
+    return socketHandle;
+}
+
+unsigned int BSDUDPSocket::getPort() const
+{
+    sockaddr_in addr;
+
+    socklen_t length = sizeof(addr);
+
+    if (getsockname(socketHandle, (sockaddr*)&addr, &length) != 0)
+    {
+        return 0;
+    }
+
+    return addr.sin_port;
+}
+
+bool BSDUDPSocket::setBlocking(const bool blocking) const
+{
+    const int flags = fcntl(socketHandle, F_GETFL, 0);
+
+    return flags != -1 && fcntl(socketHandle, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK) == 0;
+}
+
+bool BSDUDPSocket::destroy()
+{
+    if (shutdown(socketHandle, SHUT_RDWR) != 0 && errno != ENOTCONN)
+    {
+        return false;
+    }
+
+    if (close(socketHandle) != 0)
+    {
+        return false;
+    }
+
+    socketHandle = -1;
+
+    return true;
+}
+
+bool BSDUDPSocket::isAlive() const
+{
+    return socketHandle != -1;
+}
+
+BSDTCPSocket::BSDTCPSocket() {}
+
+BSDTCPSocket::BSDTCPSocket(const int socketHandle) :
+    socketHandle(socketHandle) {}
+
+bool BSDTCPSocket::create()
+{
+    socketHandle = socket(PF_INET, SOCK_STREAM, 0);
+
+    return socketHandle != -1;
+}
+
+bool BSDTCPSocket::socketBind(const std::string address, const unsigned int port) const
+{
+    int val = 1;
+
+    if (setsockopt(socketHandle, SOL_SOCKET, SO_REUSEADDR, &val, sizeof(val)) == -1)
+    {
+        return false;
+    }
+
+    sockaddr_in addr;
+
+    memset(&addr, 0, sizeof(addr));
+
+    addr.sin_family = AF_INET;
+    addr.sin_port = port;
+    addr.sin_addr.s_addr = inet_addr(address.c_str());
+
+    return bind(socketHandle, (sockaddr*)&addr, sizeof(addr)) == 0;
+}
+
+bool BSDTCPSocket::socketConnect(const std::string address, const unsigned int port) const
+{
+    sockaddr_in addr;
+
+    memset(&addr, 0, sizeof(addr));
+
+    addr.sin_family = AF_INET;
+    addr.sin_port = port;
+    addr.sin_addr.s_addr = inet_addr(address.c_str());
+
+    return connect(socketHandle, (sockaddr*)&addr, sizeof(addr)) == 0;
+}
+
+bool BSDTCPSocket::socketListen() const
+{
+    return listen(socketHandle, LISTEN_BACKLOG) == 0;
+}
+
+bool BSDTCPSocket::socketAccept()
+{
+    int clientHandle = accept(socketHandle, nullptr, nullptr);
+
+    if (clientHandle == -1)
+    {
+        return false;
+    }
+
+    socketHandle = clientHandle;
+
+    return true;
+}
+
+TCPSocket* BSDTCPSocket::acceptConnection() const
+{
+    int clientHandle = accept(socketHandle, nullptr, nullptr);
+
+    if (clientHandle == -1)
+    {
+        return nullptr;
+    }
+
+    return new BSDTCPSocket(clientHandle);
+}
+
+bool BSDTCPSocket::socketSend(const Message* message) const
+{
+    std::string& frame = getMessageBuffer();
+
+    encodeFrame(message, frame);
+
+    return sendAll(frame.data(), frame.size());
+}
+
+bool BSDTCPSocket::sendPayload(const char* data, const uint64_t size) const
+{
+    return sendAll(data, size);
+}
+
+bool BSDTCPSocket::sendVectored(const char* header, const uint64_t headerSize, const char* data, const uint64_t size) const
+{
+    iovec vectors[2] = { { (void*)header, headerSize }, { (void*)data, size } };
+
+    return sendVectors(vectors, 2);
+}
+
+bool BSDTCPSocket::sendFileRange(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const
+{
+#ifdef __linux__
+
+    if (!sendFlagged(header, headerSize, size > 0 ? MSG_MORE : 0))
+    {
+        return false;
+    }
+
+    off_t position = offset;
+
+    uint64_t sent = 0;
+
+    while (sent < size)
+    {
+        const ssize_t result = sendfile(socketHandle, file.getDescriptor(), &position, size - sent);
+
+        if (result == -1 && sent == 0 && (errno == EINVAL || errno == ENOSYS))
+        {
+            return sendFileBuffered(nullptr, 0, file, offset, size);
+        }
+
+        if (result == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            pollfd handle = { socketHandle, POLLOUT, 0 };
+
+            poll(&handle, 1, -1);
+
+            continue;
+        }
+
+        if (result <= 0)
+        {
+            return false;
+        }
+
+        sent += result;
+    }
+
+    return true;
+
+#elif __APPLE__
+
+    if (!sendAll(header, headerSize))
+    {
+        return false;
+    }
+
+    uint64_t sent = 0;
+
+    while (sent < size)
+    {
+        off_t length = size - sent;
+
+        const int result = sendfile(file.getDescriptor(), socketHandle, offset + sent, &length, nullptr, 0);
+
+        if (result == -1 && sent == 0 && length == 0 && (errno == ENOTSUP || errno == ENOTSOCK))
+        {
+            return sendFileBuffered(nullptr, 0, file, offset, size);
+        }
+
+        if (result == -1 && errno != EAGAIN && errno != EINTR)
+        {
+            return false;
+        }
+
+        if (length == 0 && result == 0)
+        {
+            return false;
+        }
+
+        sent += length;
+    }
+
+    return true;
+
+#else
+
+    return sendFileBuffered(header, headerSize, file, offset, size);
+
+#endif
+}
+
+bool BSDTCPSocket::receivePayload(char* buffer, const uint64_t size) const
+{
+    return receiveAll(buffer, size);
+}
+
+bool BSDTCPSocket::receiveToFile(const File& file, const uint64_t offset, const uint64_t size) const
+{
+#ifdef __linux__
+
+    if (pipeHandles[0] == -1 && !createPipe())
+    {
+        return receiveFileBuffered(file, offset, size);
+    }
+
+    uint64_t received = 0;
+
+    while (received < size)
+    {
+        const ssize_t result = splice(socketHandle, nullptr, pipeHandles[1], nullptr, size - received, SPLICE_F_MOVE | SPLICE_F_MORE);
+
+        if (result == -1 && received == 0 && errno == EINVAL)
+        {
+            return receiveFileBuffered(file, offset, size);
+        }
+
+        if (result <= 0)
+        {
+            return false;
+        }
+
+        loff_t position = offset + received;
+
+        ssize_t pending = result;
+
+        while (pending > 0)
+        {
+            const ssize_t written = splice(pipeHandles[0], nullptr, file.getDescriptor(), &position, pending, SPLICE_F_MOVE | SPLICE_F_MORE);
+
+            if (written == -1 && errno == EINVAL)
+            {
+                char buffer[FILE_BUFFER_SIZE];
+
+                while (pending > 0)
+                {
+                    const ssize_t drained = read(pipeHandles[0], buffer, pending < FILE_BUFFER_SIZE ? pending : FILE_BUFFER_SIZE);
+
+                    if (drained <= 0 || !file.writeAt(buffer, drained, position))
+                    {
+                        return false;
+                    }
+
+                    position += drained;
+                    pending -= drained;
+                }
+
+                received += result;
+
+                return receiveFileBuffered(file, offset + received, size - received);
+            }
+
+            if (written <= 0)
+            {
+                return false;
+            }
+
+            pending -= written;
+        }
 
-        return;
+        received += result;
     }
 
-    transferThread = std::thread([=]()
-    {
-        if (!transferSocket->socketAccept())
-        {
-            errorHandler->handle(SquirrelSocketException("Failed to accept connection."));
+    return true;
 
-            return;
-        }
+#else
 
-        const Message* message = transferSocket->receive();
+    return receiveFileBuffered(file, offset, size);
 
-        if (!message)
-        {
-            errorHandler->handle(SquirrelSocketException("Failed to receive file."));
+#endif
+}
 
-            return;
-        }
+bool BSDTCPSocket::sendFileBuffered(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const
+{
+    if (size == 0)
+    {
+        return sendAll(header, headerSize);
+    }
 
-        if (message->data->getProperty("ip")->asString() != ip)
-        {
-            errorHandler->handle(SquirrelSocketException("Invalid connection."));
+    char buffer[FILE_BUFFER_SIZE];
 
-            return;
-        }
+    uint64_t sent = 0;
 
-        const std::optional<std::string> fileName = message->data->getProperty("file")->asString();
-        const std::optional<std::string> data = message->data->getProperty("data")->asString();
+    while (sent < size)
+    {
+        const uint64_t length = size - sent < FILE_BUFFER_SIZE ? size - sent : FILE_BUFFER_SIZE;
 
-        if (!fileName || !data)
+        if (!file.readAt(buffer, length, offset + sent) || !sendVectored(header, sent == 0 ? headerSize : 0, buffer, length))
         {
-            errorHandler->handle(SquirrelSocketException("Received incorrect message format."));
-
-            return;
+            return false;
         }
 
-        handleReceive(fileName.value(), Base64::decode(data.value()));
+        sent += length;
+    }
 
-        if (!transferSocket->destroy())
-        {
-            errorHandler->handle(SquirrelSocketException("Failed to destroy socket."));
+    return true;
+}
 
-            return;
+bool BSDTCPSocket::receiveFileBuffered(const File& file, const uint64_t offset, const uint64_t size) const
+{
+    char buffer[FILE_BUFFER_SIZE];
+
+    uint64_t received = 0;
+
+    while (received < size)
+    {
+        const uint64_t length = size - received < FILE_BUFFER_SIZE ? size - received : FILE_BUFFER_SIZE;
+
+        if (!receiveAll(buffer, length) || !file.writeAt(buffer, length, offset + received))
+        {
+            return false;
         }
-    });
-}
 
-#ifdef _WIN32
+        received += length;
+    }
 
-bool WinUDPSocket::create(const std::string address)
+    return true;
+}
+
+bool BSDTCPSocket::growBuffer(const int option, const uint64_t size) const
 {
-    socketHandle = socket(PF_INET, SOCK_DGRAM, 0);
+    int current = 0;
 
-    if (socketHandle == INVALID_SOCKET)
+    socklen_t length = sizeof(current);
+
+    if (getsockopt(socketHandle, SOL_SOCKET, option, &current, &length) != 0)
     {
         return false;
     }
 
-    bool val = true;
+    uint64_t request = std::min(size, (uint64_t)TUNE_MAX_BUFFER);
 
-    if (setsockopt(socketHandle, SOL_SOCKET, SO_BROADCAST, (char*)&val, sizeof(bool)) == SOCKET_ERROR)
+#ifdef __linux__
+    // Linux reports back twice the size it grants.
+
+    std::ifstream limit(option == SO_SNDBUF ? "/proc/sys/net/core/wmem_max" : "/proc/sys/net/core/rmem_max");
+
+    uint64_t maximum = 0;
+
+    if (limit >> maximum)
     {
-        return false;
+        request = std::min(request, maximum);
     }
 
-    unsigned long addr = inet_addr(address.c_str());
+    if (request * 2 <= (uint64_t)current)
+    {
+        return true;
+    }
+#else
+    if (request <= (uint64_t)current)
+    {
+        return true;
+    }
+#endif
 
-    return setsockopt(socketHandle, IPPROTO_IP, IP_UNICAST_IF, (char*)&addr, sizeof(addr)) != SOCKET_ERROR;
+    const int value = request;
+
+    return setsockopt(socketHandle, SOL_SOCKET, option, &value, sizeof(value)) == 0;
 }
 
-bool WinUDPSocket::socketBind(const std::string address, const unsigned int port) const
+bool BSDTCPSocket::createPipe() const
 {
-    sockaddr_in addr;
+#ifdef __linux__
 
-    memset(&addr, 0, sizeof(addr));
+    if (pipe(pipeHandles) != 0)
+    {
+        pipeHandles[0] = -1;
+        pipeHandles[1] = -1;
 
-    addr.sin_family = AF_INET;
-    addr.sin_port = port;
-    addr.sin_addr.s_addr = inet_addr(address.c_str());
+        return false;
+    }
 
-    return bind(socketHandle, (sockaddr*)&addr, sizeof(addr)) != SOCKET_ERROR;
+    fcntl(pipeHandles[1], F_SETPIPE_SZ, FILE_BUFFER_SIZE * 16);
+
+    return true;
+
+#else
+
+    return false;
+
+#endif
 }
 
-bool WinUDPSocket::socketSend(const Message* message, const std::string address, const unsigned int port) const
+bool BSDTCPSocket::sendAll(const char* data, const uint64_t length) const
 {
-    sockaddr_in addr;
+    return sendFlagged(data, length, 0);
+}
 
-    memset(&addr, 0, sizeof(addr));
+bool BSDTCPSocket::sendFlagged(const char* data, const uint64_t length, const int flags) const
+{
+    uint64_t sent = 0;
 
-    addr.sin_family = AF_INET;
-    addr.sin_port = port;
-    addr.sin_addr.s_addr = inet_addr(address.c_str());
+    while (sent < length)
+    {
+        const ssize_t result = send(socketHandle, data + sent, length - sent, MSG_NOSIGNAL | flags);
+
+        if (result == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            pollfd handle = { socketHandle, POLLOUT, 0 };
+
+            poll(&handle, 1, -1);
 
-    std::stringstream stream;
+            continue;
+        }
 
-    message->serialize(stream);
+        if (result <= 0)
+        {
+            return false;
+        }
 
-    const std::string& str = stream.str();
+        sent += result;
+    }
 
-    return sendto(socketHandle, str.c_str(), str.size() + 1, 0, (sockaddr*)&addr, sizeof(addr)) == str.size() + 1;
+    return true;
 }
 
-Message* WinUDPSocket::receive() const
+bool BSDTCPSocket::sendVectors(iovec* vectors, int count) const
 {
-    char buffer[BUFFER_SIZE];
+    advanceVectors(vectors, count, 0);
 
-    if (recv(socketHandle, buffer, BUFFER_SIZE, 0) == -1)
+    while (count > 0)
     {
-        return nullptr;
-    }
+        msghdr message = {};
 
-    buffer[BUFFER_SIZE - 1] = '\0';
+        message.msg_iov = vectors;
+        message.msg_iovlen = count;
 
-    std::stringstream stream(buffer);
+        const ssize_t result = sendmsg(socketHandle, &message, MSG_NOSIGNAL);
 
-    return Message::deserialize(stream);
-}
+        if (result == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            pollfd handle = { socketHandle, POLLOUT, 0 };
 
-bool WinUDPSocket::destroy()
-{
-    if (shutdown(socketHandle, SD_BOTH) == SOCKET_ERROR)
-    {
-        return false;
-    }
+            poll(&handle, 1, -1);
 
-    if (closesocket(socketHandle) == SOCKET_ERROR)
-    {
-        return false;
-    }
+            continue;
+        }
 
-    socketHandle = INVALID_SOCKET;
+        if (result <= 0)
+        {
+            return false;
+        }
+
+        advanceVectors(vectors, count, result);
+    }
 
     return true;
 }
 
-bool WinUDPSocket::isAlive() const
+bool BSDTCPSocket::receiveAll(char* buffer, const uint64_t length) const
 {
-    return socketHandle != INVALID_SOCKET;
-}
+    uint64_t received = 0;
 
-bool WinTCPSocket::create()
-{
-    socketHandle = socket(PF_INET, SOCK_STREAM, 0);
+    while (received < length)
+    {
+        const ssize_t result = recv(socketHandle, buffer + received, length - received, 0);
 
-    return socketHandle != INVALID_SOCKET;
+        if (result <= 0)
+        {
+            return false;
+        }
+
+        received += result;
+    }
+
+    return true;
 }
 
-bool WinTCPSocket::socketBind(const std::string address, const unsigned int port) const
+bool BSDTCPSocket::receiveAvailable(std::string& buffer) const
 {
-    sockaddr_in addr;
+    char data[FILE_BUFFER_SIZE];
 
-    memset(&addr, 0, sizeof(addr));
+    while (true)
+    {
+        const ssize_t result = recv(socketHandle, data, FILE_BUFFER_SIZE, 0);
 
-    addr.sin_family = AF_INET;
-    addr.sin_port = port;
-    addr.sin_addr.s_addr = inet_addr(address.c_str());
+        if (result == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return true;
+        }
 
-    return bind(socketHandle, (sockaddr*)&addr, sizeof(addr)) != SOCKET_ERROR;
+        if (result <= 0)
+        {
+            return false;
+        }
+
+        buffer.append(data, result);
+    }
 }
 
-bool WinTCPSocket::socketConnect(const std::string address, const unsigned int port) const
+SocketHandle BSDTCPSocket::getHandle() const
 {
-    sockaddr_in addr;
-
-    memset(&addr, 0, sizeof(addr));
-
-    addr.sin_family = AF_INET;
-    addr.sin_port = port;
-    addr.sin_addr.s_addr = inet_addr(address.c_str());
-
-    return connect(socketHandle, (sockaddr*)&addr, sizeof(addr)) != SOCKET_ERROR;
+    return socketHandle;
 }
 
-bool WinTCPSocket::socketListen() const
+bool BSDTCPSocket::setBlocking(const bool blocking) const
 {
-    return listen(socketHandle, 1) != SOCKET_ERROR;
+    const int flags = fcntl(socketHandle, F_GETFL, 0);
+
+    return flags != -1 && fcntl(socketHandle, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK) == 0;
 }
 
-bool WinTCPSocket::socketAccept()
+bool BSDTCPSocket::setProfile(const SocketProfile profile) const
 {
-    SOCKET clientHandle = accept(socketHandle, nullptr, nullptr);
+    const int enabled = 1;
 
-    if (clientHandle == INVALID_SOCKET)
+    if (setsockopt(socketHandle, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled)) != 0)
     {
         return false;
     }
 
-    if (closesocket(socketHandle) == SOCKET_ERROR)
+#ifdef TCP_NOTSENT_LOWAT
+    if (profile == SocketProfile::SocketBulk)
     {
-        return false;
-    }
+        const int lowWater = TUNE_NOTSENT_LOWAT;
 
-    socketHandle = clientHandle;
+        return setsockopt(socketHandle, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &lowWater, sizeof(lowWater)) == 0;
+    }
+#endif
 
     return true;
 }
 
-bool WinTCPSocket::socketSend(const Message* message) const
+bool BSDTCPSocket::setBuffers(const uint64_t sendBuffer, const uint64_t receiveBuffer) const
 {
-    std::stringstream stream;
+    return growBuffer(SO_SNDBUF, sendBuffer) && growBuffer(SO_RCVBUF, receiveBuffer);
+}
 
-    stream << "00000000";
+bool BSDTCPSocket::getTuning(SocketTuning& tuning) const
+{
+    int sendSize = 0;
+    int receiveSize = 0;
+    int noDelay = 0;
 
-    message->serialize(stream);
+    socklen_t length = sizeof(sendSize);
 
-    const std::string& str = stream.str();
+    if (getsockopt(socketHandle, SOL_SOCKET, SO_SNDBUF, &sendSize, &length) != 0)
+    {
+        return false;
+    }
 
-    *(uint64_t*)str.data() = str.size() - 7;
+    length = sizeof(receiveSize);
 
-    return send(socketHandle, str.c_str(), str.size() + 1, 0) == str.size() + 1;
-}
+    if (getsockopt(socketHandle, SOL_SOCKET, SO_RCVBUF, &receiveSize, &length) != 0)
+    {
+        return false;
+    }
 
-Message* WinTCPSocket::receive() const
-{
-    char buffer[8];
+    length = sizeof(noDelay);
 
-    if (recv(socketHandle, buffer, 8, 0) == -1)
+    if (getsockopt(socketHandle, IPPROTO_TCP, TCP_NODELAY, &noDelay, &length) != 0)
     {
-        return nullptr;
+        return false;
     }
 
-    uint64_t length = *(uint64_t*)buffer;
+    tuning.sendBuffer = sendSize;
+    tuning.receiveBuffer = receiveSize;
+    tuning.noDelay = noDelay != 0;
 
-    char* data = (char*)malloc(sizeof(char) * (length + 1));
+#ifdef TCP_NOTSENT_LOWAT
+    int lowWater = 0;
 
-    int received = 0;
+    length = sizeof(lowWater);
 
-    do {
-        int result = recv(socketHandle, data + received, length - received, 0);
-
-        if (result == -1)
-        {
-            free(data);
+    if (getsockopt(socketHandle, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &lowWater, &length) == 0)
+    {
+        tuning.notSentLowWater = lowWater;
+    }
+#endif
 
-            return nullptr;
-        }
+#ifdef __linux__
+    tcp_info info = {};
 
-        received += result;
-    } while (received < length);
+    length = sizeof(info);
 
-    data[length] = '\0';
+    if (getsockopt(socketHandle, IPPROTO_TCP, TCP_INFO, &info, &length) == 0)
+    {
+        tuning.roundTrip = info.tcpi_rtt / 1000000.0;
+    }
+#elif __APPLE__
+    tcp_connection_info info = {};
 
-    std::stringstream stream(data);
+    length = sizeof(info);
 
-    free(data);
+    if (getsockopt(socketHandle, IPPROTO_TCP, TCP_CONNECTION_INFO, &info, &length) == 0)
+    {
+        tuning.roundTrip = info.tcpi_srtt / 1000.0;
+    }
+#endif
 
-    return Message::deserialize(stream);
+    return true;
 }
 
-bool WinTCPSocket::destroy()
+bool BSDTCPSocket::destroy()
 {
-    if (shutdown(socketHandle, SD_BOTH) == SOCKET_ERROR && WSAGetLastError() != WSAENOTCONN)
+    if (shutdown(socketHandle, SHUT_RDWR) != 0 && errno != ENOTCONN)
     {
         return false;
     }
 
-    if (closesocket(socketHandle) == SOCKET_ERROR)
+    if (close(socketHandle) != 0)
     {
         return false;
     }
 
-    socketHandle = INVALID_SOCKET;
+#ifdef __linux__
+
+    if (pipeHandles[0] != -1)
+    {
+        close(pipeHandles[0]);
+        close(pipeHandles[1]);
+
+        pipeHandles[0] = -1;
+        pipeHandles[1] = -1;
+    }
+
+#endif
+
+    socketHandle = -1;
 
     return true;
 }
 
-bool WinTCPSocket::isAlive() const
+bool BSDTCPSocket::isAlive() const
 {
-    return socketHandle != INVALID_SOCKET;
+    return socketHandle != -1;
 }
 
-WinNetworkManager::WinNetworkManager(ErrorHandler* errorHandler) :
-    NetworkManager(errorHandler, getName(), getAddress())
+#ifdef __linux__
+
+bool UringUDPSocket::socketSend(const Message* message, const std::string address, const unsigned int port) const
 {
-    WSADATA wsaData;
+    IoRing* ring = IoRing::getLocal();
 
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+    if (!ring)
     {
-        errorHandler->handle(SquirrelSocketException("Failed to initialize WinSock."));
+        return BSDUDPSocket::socketSend(message, address, port);
     }
-}
-
-WinNetworkManager::~WinNetworkManager()
-{
-    WSACleanup();
-}
-
-unsigned int WinNetworkManager::convertAddress(const std::string address) const
-{
-    return inet_addr(address.c_str());
-}
 
-std::string WinNetworkManager::convertAddress(const unsigned int address) const
-{
-    in_addr addr;
+    sockaddr_in addr;
 
-    addr.s_addr = address;
+    memset(&addr, 0, sizeof(addr));
 
-    return inet_ntoa(addr);
-}
+    addr.sin_family = AF_INET;
+    addr.sin_port = port;
+    addr.sin_addr.s_addr = inet_addr(address.c_str());
 
-UDPSocket* WinNetworkManager::newUDPSocket() const
-{
-    return new WinUDPSocket();
-}
+    std::string& datagram = getMessageBuffer();
 
-TCPSocket* WinNetworkManager::newTCPSocket() const
-{
-    return new WinTCPSocket();
-}
+    if (!encodeDatagram(message, datagram))
+    {
+        return false;
+    }
 
-std::string WinNetworkManager::getName() const
-{
-    char buffer[UNLEN + 1];
+    iovec vector = { datagram.data(), datagram.size() };
 
-    unsigned long size = UNLEN + 1;
+    msghdr header;
 
-    if (!GetUserName(buffer, &size))
+    memset(&header, 0, sizeof(header));
+
+    header.msg_name = &addr;
+    header.msg_namelen = sizeof(addr);
+    header.msg_iov = &vector;
+    header.msg_iovlen = 1;
+
+    if (!ring->prepare(IORING_OP_SENDMSG, socketHandle, &header, 1, 0, 0))
     {
-        return "";
+        return false;
     }
 
-    return buffer;
+    return ring->execute() == (int)datagram.size();
 }
 
-std::string WinNetworkManager::getAddress() const
+int64_t UringUDPSocket::receiveDatagram(char* buffer, const uint64_t size, std::string& address, unsigned int& port) const
 {
-    unsigned long size = sizeof(IP_ADAPTER_ADDRESSES) * 32;
+    if (next == staged)
+    {
+        IoRing* ring = IoRing::getLocal();
 
-    IP_ADAPTER_ADDRESSES* addrs = (IP_ADAPTER_ADDRESSES*)malloc(size);
+        if (!ring)
+        {
+            return BSDUDPSocket::receiveDatagram(buffer, size, address, port);
+        }
 
-    if (GetAdaptersAddresses(AF_INET, 0, nullptr, addrs, &size) != NO_ERROR)
-    {
-        free(addrs);
+        // RECVMSG waits on a non-blocking socket unless MSG_DONTWAIT is set.
 
-        return "";
-    }
+        datagrams.resize(URING_DATAGRAMS * size);
 
-    IP_ADAPTER_ADDRESSES* head = addrs;
+        slotSize = size;
 
-    while (addrs)
-    {
-        NL_NETWORK_CONNECTIVITY_HINT hint;
+        msghdr messages[URING_DATAGRAMS];
+        iovec vectors[URING_DATAGRAMS];
 
-        if (GetNetworkConnectivityHintForInterface(addrs->IfIndex, &hint) == NO_ERROR && hint.ConnectivityLevel == NetworkConnectivityLevelHintInternetAccess)
+        int results[URING_DATAGRAMS];
+
+        for (unsigned int i = 0; i < URING_DATAGRAMS; i++)
         {
-            if (addrs->IfType != IF_TYPE_SOFTWARE_LOOPBACK && addrs->OperStatus == IfOperStatusUp)
+            vectors[i] = { datagrams.data() + i * size, size };
+
+            memset(&messages[i], 0, sizeof(msghdr));
+
+            messages[i].msg_name = &addresses[i];
+            messages[i].msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_iov = &vectors[i];
+            messages[i].msg_iovlen = 1;
+
+            io_uring_sqe* receive = ring->prepare(IORING_OP_RECVMSG, socketHandle, &messages[i], 1, 0, i);
+
+            if (!receive)
             {
-                break;
+                return -1;
+            }
+
+            receive->msg_flags = MSG_DONTWAIT;
+
+            if (i + 1 < URING_DATAGRAMS)
+            {
+                receive->flags |= IOSQE_IO_LINK;
             }
         }
 
-        addrs = addrs->Next;
-    }
+        if (!ring->wait(URING_DATAGRAMS, results))
+        {
+            return -1;
+        }
 
-    if (!addrs)
-    {
-        free(head);
+        staged = 0;
+        next = 0;
 
-        return "";
+        while (staged < URING_DATAGRAMS && results[staged] >= 0)
+        {
+            lengths[staged] = results[staged];
+
+            staged++;
+        }
+
+        if (staged == 0)
+        {
+            return -1;
+        }
     }
 
-    char* address = inet_ntoa(((sockaddr_in*)addrs->FirstUnicastAddress->Address.lpSockaddr)->sin_addr);
+    const unsigned int slot = next++;
 
-    free(head);
+    const uint64_t length = std::min((uint64_t)lengths[slot], size);
 
-    return address;
+    memcpy(buffer, datagrams.data() + slot * slotSize, length);
+
+    char text[INET_ADDRSTRLEN];
+
+    inet_ntop(AF_INET, &addresses[slot].sin_addr, text, sizeof(text));
+
+    address = text;
+    port = addresses[slot].sin_port;
+
+    return length;
 }
 
-#else
+UringTCPSocket::UringTCPSocket() {}
 
-bool BSDUDPSocket::create(const std::string address)
+UringTCPSocket::UringTCPSocket(const int socketHandle) :
+    BSDTCPSocket(socketHandle) {}
+
+TCPSocket* UringTCPSocket::acceptConnection() const
 {
-    socketHandle = socket(PF_INET, SOCK_DGRAM, 0);
+    int clientHandle = accept(socketHandle, nullptr, nullptr);
 
-    if (socketHandle == -1)
+    if (clientHandle == -1)
     {
-        return false;
+        return nullptr;
     }
 
-    int val = 1;
+    return new UringTCPSocket(clientHandle);
+}
 
-    if (setsockopt(socketHandle, SOL_SOCKET, SO_BROADCAST, &val, sizeof(val)) == -1)
+bool UringTCPSocket::sendFileRange(const char* header, const uint64_t headerSize, const File& file, const uint64_t offset, const uint64_t size) const
+{
+    IoRing* ring = IoRing::getLocal();
+
+    if (!ring || headerSize >= URING_BUFFER_SIZE)
     {
-        return false;
+        return BSDTCPSocket::sendFileRange(header, headerSize, file, offset, size);
     }
 
-    ip_mreq req;
+    if (size == 0)
+    {
+        return sendAll(header, headerSize);
+    }
 
-    req.imr_interface.s_addr = inet_addr(address.c_str());
-    req.imr_multiaddr.s_addr = inet_addr(address.c_str());
+    uint64_t prefix = headerSize;
+    uint64_t position = 0;
 
-    return setsockopt(socketHandle, IPPROTO_IP, IP_MULTICAST_IF, &req, sizeof(req)) != -1;
-}
+    while (position < size)
+    {
+        iovec vectors[URING_BUFFERS];
 
-bool BSDUDPSocket::socketBind(const std::string address, const unsigned int port) const
-{
-    sockaddr_in addr;
+        uint64_t lengths[URING_BUFFERS];
 
-    memset(&addr, 0, sizeof(addr));
+        int results[URING_BUFFERS + 1];
 
-    addr.sin_family = AF_INET;
-    addr.sin_port = port;
-    addr.sin_addr.s_addr = inet_addr(address.c_str());
+        uint64_t start = position;
 
-    return bind(socketHandle, (sockaddr*)&addr, sizeof(addr)) == 0;
-}
+        int count = 0;
 
-bool BSDUDPSocket::socketSend(const Message* message, const std::string address, const unsigned int port) const
-{
-    sockaddr_in addr;
+        for (; count < URING_BUFFERS && start < size; count++)
+        {
+            char* buffer = ring->getBuffer(count);
 
-    memset(&addr, 0, sizeof(addr));
+            const uint64_t head = count == 0 ? prefix : 0;
+            const uint64_t length = std::min(size - start, URING_BUFFER_SIZE - head);
 
-    addr.sin_family = AF_INET;
-    addr.sin_port = port;
-    addr.sin_addr.s_addr = inet_addr(address.c_str());
+            memcpy(buffer, header + headerSize - head, head);
 
-    std::stringstream stream;
+            io_uring_sqe* read = ring->prepare(IORING_OP_READ_FIXED, file.getDescriptor(), buffer + head, length, offset + start, count);
 
-    message->serialize(stream);
+            if (!read)
+            {
+                return false;
+            }
 
-    const std::string& str = stream.str();
+            read->buf_index = count;
+            read->flags |= IOSQE_IO_LINK;
 
-    return sendto(socketHandle, str.c_str(), str.size() + 1, 0, (sockaddr*)&addr, sizeof(addr)) == str.size() + 1;
-}
+            vectors[count] = { buffer, head + length };
+            lengths[count] = length;
 
-Message* BSDUDPSocket::receive() const
-{
-    char buffer[BUFFER_SIZE];
+            start += length;
+        }
 
-    if (recv(socketHandle, buffer, BUFFER_SIZE, 0) == -1)
-    {
-        return nullptr;
-    }
+        msghdr message = {};
 
-    buffer[BUFFER_SIZE - 1] = '\0';
+        message.msg_iov = vectors;
+        message.msg_iovlen = count;
 
-    std::stringstream stream(buffer);
+        io_uring_sqe* send = ring->prepare(IORING_OP_SENDMSG, socketHandle, &message, 1, 0, count);
 
-    return Message::deserialize(stream);
-}
+        if (!send)
+        {
+            return false;
+        }
 
-bool BSDUDPSocket::destroy()
-{
-    if (shutdown(socketHandle, SHUT_RDWR) != 0)
-    {
-        return false;
-    }
+        send->msg_flags = MSG_NOSIGNAL;
 
-    socketHandle = -1;
+        if (!ring->wait(count + 1, results))
+        {
+            return false;
+        }
+
+        // A short read means the file shrank under the send.
+
+        for (int i = 0; i < count; i++)
+        {
+            if (results[i] < 0 || (uint64_t)results[i] != lengths[i])
+            {
+                return false;
+            }
+        }
+
+        if (results[count] < 0 && results[count] != -EAGAIN)
+        {
+            return false;
+        }
+
+        iovec* remaining = vectors;
+
+        advanceVectors(remaining, count, results[count] > 0 ? results[count] : 0);
+
+        if (count > 0 && !sendVectors(remaining, count))
+        {
+            return false;
+        }
+
+        position = start;
+        prefix = 0;
+    }
 
     return true;
 }
 
-bool BSDUDPSocket::isAlive() const
+bool UringTCPSocket::receiveAvailable(std::string& buffer) const
 {
-    return socketHandle != -1;
-}
+    IoRing* ring = IoRing::getLocal();
 
-bool BSDTCPSocket::create()
-{
-    socketHandle = socket(PF_INET, SOCK_STREAM, 0);
+    if (!ring)
+    {
+        return BSDTCPSocket::receiveAvailable(buffer);
+    }
 
-    return socketHandle != -1;
-}
+    while (true)
+    {
+        int results[URING_BUFFERS];
 
-bool BSDTCPSocket::socketBind(const std::string address, const unsigned int port) const
-{
-    sockaddr_in addr;
+        for (unsigned int i = 0; i < URING_BUFFERS; i++)
+        {
+            io_uring_sqe* read = ring->prepare(IORING_OP_READ_FIXED, socketHandle, ring->getBuffer(i), URING_BUFFER_SIZE, 0, i);
 
-    memset(&addr, 0, sizeof(addr));
+            if (!read)
+            {
+                return false;
+            }
 
-    addr.sin_family = AF_INET;
-    addr.sin_port = port;
-    addr.sin_addr.s_addr = inet_addr(address.c_str());
+            read->buf_index = i;
 
-    return bind(socketHandle, (sockaddr*)&addr, sizeof(addr)) == 0;
-}
+            if (i + 1 < URING_BUFFERS)
+            {
+                read->flags |= IOSQE_IO_LINK;
+            }
+        }
 
-bool BSDTCPSocket::socketConnect(const std::string address, const unsigned int port) const
-{
-    sockaddr_in addr;
+        if (!ring->wait(URING_BUFFERS, results))
+        {
+            return false;
+        }
 
-    memset(&addr, 0, sizeof(addr));
+        for (unsigned int i = 0; i < URING_BUFFERS; i++)
+        {
+            if (results[i] == -EAGAIN || results[i] == -ECANCELED)
+            {
+                return true;
+            }
 
-    addr.sin_family = AF_INET;
-    addr.sin_port = port;
-    addr.sin_addr.s_addr = inet_addr(address.c_str());
+            if (results[i] <= 0)
+            {
+                return false;
+            }
 
-    return connect(socketHandle, (sockaddr*)&addr, sizeof(addr)) == 0;
-}
+            buffer.append(ring->getBuffer(i), results[i]);
+        }
 
-bool BSDTCPSocket::socketListen() const
-{
-    return listen(socketHandle, 1) == 0;
+        if (results[URING_BUFFERS - 1] < URING_BUFFER_SIZE)
+        {
+            return true;
+        }
+    }
 }
 
-bool BSDTCPSocket::socketAccept()
+bool UringTCPSocket::sendAll(const char* data, const uint64_t length) const
 {
-    int clientHandle = accept(socketHandle, nullptr, nullptr);
+    IoRing* ring = IoRing::getLocal();
 
-    if (clientHandle == -1)
+    if (!ring)
     {
-        return false;
+        return BSDTCPSocket::sendAll(data, length);
     }
 
-    socketHandle = clientHandle;
+    uint64_t sent = 0;
 
-    return true;
-}
+    while (sent < length)
+    {
+        const uint64_t remaining = length - sent < URING_BUFFER_SIZE * 16 ? length - sent : URING_BUFFER_SIZE * 16;
 
-bool BSDTCPSocket::socketSend(const Message* message) const
-{
-    std::stringstream stream;
+        io_uring_sqe* send = ring->prepare(IORING_OP_SEND, socketHandle, data + sent, remaining, 0, 0);
+
+        if (!send)
+        {
+            return false;
+        }
+
+        send->msg_flags = MSG_NOSIGNAL;
+
+        const int result = ring->execute();
+
+        if (result == -EAGAIN)
+        {
+            pollfd handle = { socketHandle, POLLOUT, 0 };
 
-    stream << "00000000";
+            poll(&handle, 1, -1);
 
-    message->serialize(stream);
+            continue;
+        }
 
-    const std::string& str = stream.str();
+        if (result <= 0)
+        {
+            return false;
+        }
 
-    *(uint64_t*)str.data() = str.size() - 7;
+        sent += result;
+    }
 
-    return send(socketHandle, str.c_str(), str.size() + 1, MSG_NOSIGNAL) == str.size() + 1;
+    return true;
 }
 
-Message* BSDTCPSocket::receive() const
+bool UringTCPSocket::sendVectors(iovec* vectors, int count) const
 {
-    char buffer[8];
+    IoRing* ring = IoRing::getLocal();
 
-    if (recv(socketHandle, buffer, 8, 0) == -1)
+    if (!ring)
     {
-        return nullptr;
+        return BSDTCPSocket::sendVectors(vectors, count);
     }
 
-    uint64_t length = *(uint64_t*)buffer;
+    advanceVectors(vectors, count, 0);
 
-    char* data = (char*)malloc(sizeof(char) * (length + 1));
+    while (count > 0)
+    {
+        msghdr message = {};
 
-    int received = 0;
+        message.msg_iov = vectors;
+        message.msg_iovlen = count;
 
-    do {
-        int result = recv(socketHandle, data + received, length - received, 0);
+        io_uring_sqe* send = ring->prepare(IORING_OP_SENDMSG, socketHandle, &message, 1, 0, 0);
 
-        if (result == -1)
+        if (!send)
         {
-            free(data);
-
-            return nullptr;
+            return false;
         }
 
-        received += result;
-    } while (received < length);
+        send->msg_flags = MSG_NOSIGNAL;
+
+        const int result = ring->execute();
 
-    data[length] = '\0';
+        if (result == -EAGAIN)
+        {
+            pollfd handle = { socketHandle, POLLOUT, 0 };
+
+            poll(&handle, 1, -1);
+
+            continue;
+        }
 
-    std::stringstream stream(data);
+        if (result <= 0)
+        {
+            return false;
+        }
 
-    free(data);
+        advanceVectors(vectors, count, result);
+    }
 
-    return Message::deserialize(stream);
+    return true;
 }
 
-bool BSDTCPSocket::destroy()
+bool UringTCPSocket::receiveAll(char* buffer, const uint64_t length) const
 {
-    if (shutdown(socketHandle, SHUT_RDWR) != 0 && errno != ENOTCONN)
+    IoRing* ring = IoRing::getLocal();
+
+    if (!ring)
     {
-        return false;
+        return BSDTCPSocket::receiveAll(buffer, length);
     }
 
-    socketHandle = -1;
+    uint64_t received = 0;
+
+    while (received < length)
+    {
+        const uint64_t remaining = length - received < URING_BUFFER_SIZE * 16 ? length - received : URING_BUFFER_SIZE * 16;
+
+        io_uring_sqe* receive = ring->prepare(IORING_OP_RECV, socketHandle, buffer + received, remaining, 0, 0);
+
+        if (!receive)
+        {
+            return false;
+        }
+
+        receive->msg_flags = MSG_WAITALL;
+
+        const int result = ring->execute();
+
+        if (result <= 0)
+        {
+            return false;
+        }
+
+        received += result;
+    }
 
     return true;
 }
 
-bool BSDTCPSocket::isAlive() const
-{
-    return socketHandle != -1;
-}
+#endif
 
 BSDNetworkManager::BSDNetworkManager(ErrorHandler* errorHandler) :
     NetworkManager(errorHandler, getName(), getAddress()) {}
@@ -979,11 +6316,29 @@ std::string BSDNetworkManager::convertAddress(const unsigned int address) const
 
 UDPSocket* BSDNetworkManager::newUDPSocket() const
 {
+#ifdef __linux__
+
+    if (ioUring && IoRing::isSupported())
+    {
+        return new UringUDPSocket();
+    }
+
+#endif
+
     return new BSDUDPSocket();
 }
 
 TCPSocket* BSDNetworkManager::newTCPSocket() const
 {
+#ifdef __linux__
+
+    if (ioUring && IoRing::isSupported())
+    {
+        return new UringTCPSocket();
+    }
+
+#endif
+
     return new BSDTCPSocket();
 }
 
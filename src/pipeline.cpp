@@ -0,0 +1,312 @@
+#include "../include/pipeline.h"
+
+BlockQueue::BlockQueue(const size_t capacity) :
+    capacity(capacity) {}
+
+bool BlockQueue::push(PipelineBlock* block)
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    signal.wait(guard, [&]()
+    {
+        return aborted || closed || blocks.size() < capacity;
+    });
+
+    if (aborted || closed)
+    {
+        return false;
+    }
+
+    blocks.push(block);
+
+    signal.notify_all();
+
+    return true;
+}
+
+bool BlockQueue::pop(PipelineBlock*& block)
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    signal.wait(guard, [&]()
+    {
+        return aborted || closed || !blocks.empty();
+    });
+
+    if (aborted || blocks.empty())
+    {
+        return false;
+    }
+
+    block = blocks.front();
+
+    blocks.pop();
+
+    signal.notify_all();
+
+    return true;
+}
+
+void BlockQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        closed = true;
+    }
+
+    signal.notify_all();
+}
+
+void BlockQueue::abort()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        aborted = true;
+    }
+
+    signal.notify_all();
+}
+
+Pipeline::~Pipeline()
+{
+    for (PipelineStage* stage : stages)
+    {
+        delete stage;
+    }
+
+    for (BlockQueue* queue : queues)
+    {
+        delete queue;
+    }
+
+    for (PipelineBlock* block : blocks)
+    {
+        delete block;
+    }
+}
+
+void Pipeline::addStage(const std::string name, const unsigned int workers, const std::function<bool(PipelineBlock*, const unsigned int)> process)
+{
+    PipelineStage* stage = new PipelineStage();
+
+    stage->name = name;
+    stage->workers = workers > 0 ? workers : 1;
+    stage->process = process;
+
+    stages.push_back(stage);
+}
+
+bool Pipeline::run(const std::function<bool(PipelineBlock*)> next)
+{
+    size_t count = 0;
+
+    for (PipelineStage* stage : stages)
+    {
+        queues.push_back(new BlockQueue(PIPELINE_DEPTH));
+
+        count += PIPELINE_DEPTH + stage->workers;
+    }
+
+    BlockQueue* pool = new BlockQueue(count);
+
+    queues.push_back(pool);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        blocks.push_back(new PipelineBlock());
+
+        pool->push(blocks.back());
+    }
+
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < stages.size(); i++)
+    {
+        stages[i]->remaining = stages[i]->workers;
+
+        for (unsigned int j = 0; j < stages[i]->workers; j++)
+        {
+            threads.push_back(std::thread(&Pipeline::work, this, i, j));
+        }
+    }
+
+    PipelineBlock* block = nullptr;
+
+    while (!failed && pool->pop(block))
+    {
+        if (!next(block))
+        {
+            pool->push(block);
+
+            break;
+        }
+
+        if (!queues[0]->push(block))
+        {
+            break;
+        }
+    }
+
+    queues[0]->close();
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    return !failed;
+}
+
+std::vector<StageCounters> Pipeline::getCounters() const
+{
+    std::vector<StageCounters> counters;
+
+    for (const PipelineStage* stage : stages)
+    {
+        StageCounters counter;
+
+        counter.name = stage->name;
+        counter.workers = stage->workers;
+        counter.items = stage->items;
+        counter.busy = stage->busy / 1e9;
+        counter.idle = stage->idle / 1e9;
+
+        counters.push_back(counter);
+    }
+
+    return counters;
+}
+
+void Pipeline::work(const size_t index, const unsigned int worker)
+{
+    PipelineStage* stage = stages[index];
+
+    BlockQueue* input = queues[index];
+    BlockQueue* output = queues[index + 1];
+
+    PipelineBlock* block = nullptr;
+
+    std::chrono::time_point<std::chrono::steady_clock> waiting = std::chrono::steady_clock::now();
+
+    while (input->pop(block))
+    {
+        const std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+
+        if (!stage->process(block, worker))
+        {
+            fail();
+
+            break;
+        }
+
+        const std::chrono::time_point<std::chrono::steady_clock> end = std::chrono::steady_clock::now();
+
+        stage->idle += std::chrono::duration_cast<std::chrono::nanoseconds>(start - waiting).count();
+        stage->busy += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        stage->items++;
+
+        if (!output->push(block))
+        {
+            break;
+        }
+
+        waiting = end;
+    }
+
+    if (--stage->remaining == 0 && index + 1 < stages.size())
+    {
+        queues[index + 1]->close();
+    }
+}
+
+void Pipeline::fail()
+{
+    failed = true;
+
+    for (BlockQueue* queue : queues)
+    {
+        queue->abort();
+    }
+}
+
+ChunkCache::ChunkCache(const size_t window) :
+    window(window) {}
+
+std::shared_ptr<SharedChunk> ChunkCache::acquire(const File& file, const std::string source, const Chunk& chunk)
+{
+    const std::string key = source + ":" + std::to_string(chunk.offset);
+
+    std::shared_ptr<SharedChunk> shared = nullptr;
+
+    {
+        std::unique_lock<std::mutex> guard(lock);
+
+        const std::unordered_map<std::string, std::shared_ptr<SharedChunk>>::iterator cached = chunks.find(key);
+
+        if (cached != chunks.end())
+        {
+            shared = cached->second;
+
+            signal.wait(guard, [&]()
+            {
+                return shared->ready;
+            });
+
+            return shared->valid ? shared : nullptr;
+        }
+
+        shared = std::make_shared<SharedChunk>();
+
+        chunks[key] = shared;
+
+        order.push_back(key);
+
+        while (order.size() > window)
+        {
+            chunks.erase(order.front());
+
+            order.pop_front();
+        }
+    }
+
+    shared->data.resize(chunk.size);
+
+    const bool valid = file.readAt(shared->data.data(), chunk.size, chunk.offset);
+
+    if (valid)
+    {
+        shared->hash = XXHash64::digest(shared->data.data(), chunk.size, 0);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        shared->ready = true;
+        shared->valid = valid;
+
+        if (!valid && chunks.count(key) && chunks[key] == shared)
+        {
+            chunks.erase(key);
+
+            order.erase(std::find(order.begin(), order.end(), key));
+        }
+    }
+
+    signal.notify_all();
+
+    return valid ? shared : nullptr;
+}
+
+uint64_t ChunkCache::compress(SharedChunk* shared, const Chunk& chunk, Compressor& compressor)
+{
+    std::call_once(shared->compressing, [&]()
+    {
+        shared->compressed.resize(Compressor::bound(chunk.size));
+
+        shared->compressedSize = compressor.compressChunk(shared->data.data(), chunk.size, shared->compressed.data(), shared->compressed.size());
+    });
+
+    return shared->compressedSize;
+}
@@ -0,0 +1,182 @@
+#include "../include/protocol.h"
+
+static MessageType findType(const std::string_view name)
+{
+    for (unsigned int type = MessageType::MessageUnknown + 1; type < MessageType::MessageTypeCount; type++)
+    {
+        if (name == MESSAGE_DESCRIPTORS[type].name)
+        {
+            return (MessageType)type;
+        }
+    }
+
+    return MessageType::MessageUnknown;
+}
+
+static MessageField findField(const MessageField* fields, const std::string_view name)
+{
+    for (unsigned int i = 0; i < MESSAGE_FIELD_LIMIT && fields[i] != MessageField::FieldNone; i++)
+    {
+        if (name == FIELD_DESCRIPTORS[fields[i]].name)
+        {
+            return fields[i];
+        }
+    }
+
+    return MessageField::FieldNone;
+}
+
+ProtocolMessage::ProtocolMessage() {}
+
+ProtocolMessage::ProtocolMessage(const MessageType type) :
+    type(type), typeName(MESSAGE_DESCRIPTORS[type].name) {}
+
+bool ProtocolMessage::decode(const JSONView& view, ProtocolMessage& message)
+{
+    const std::optional<std::string_view> type = view.getProperty("type").asString();
+
+    message.present = 0;
+
+    if (!type)
+    {
+        return false;
+    }
+
+    message.typeName = type.value();
+    message.type = findType(type.value());
+
+    const MessageDescriptor& descriptor = MESSAGE_DESCRIPTORS[message.type];
+
+    size_t position = 0;
+
+    std::string_view name;
+
+    JSONView value;
+
+    while (view.next(position, name, value))
+    {
+        MessageField field = findField(descriptor.required, name);
+
+        if (field == MessageField::FieldNone)
+        {
+            field = findField(descriptor.optional, name);
+        }
+
+        if (field == MessageField::FieldNone)
+        {
+            continue;
+        }
+
+        if (FIELD_DESCRIPTORS[field].encoding == FieldEncoding::EncodedInteger)
+        {
+            const std::optional<uint64_t> integer = value.asInteger();
+
+            if (!integer)
+            {
+                return false;
+            }
+
+            message.integers[field] = integer.value();
+        }
+
+        else
+        {
+            const std::optional<std::string_view> str = value.asString();
+
+            if (!str)
+            {
+                return false;
+            }
+
+            message.strings[field] = str.value();
+        }
+
+        message.present |= 1 << field;
+    }
+
+    for (unsigned int i = 0; i < MESSAGE_FIELD_LIMIT && descriptor.required[i] != MessageField::FieldNone; i++)
+    {
+        if (!message.has(descriptor.required[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ProtocolMessage::encode(std::string& buffer) const
+{
+    buffer.append("{type:\"");
+    buffer.append(MESSAGE_DESCRIPTORS[type].name);
+    buffer += '"';
+
+    for (const MessageField field : MESSAGE_DESCRIPTORS[type].required)
+    {
+        encodeField(buffer, field);
+    }
+
+    for (const MessageField field : MESSAGE_DESCRIPTORS[type].optional)
+    {
+        encodeField(buffer, field);
+    }
+
+    buffer += '}';
+}
+
+void ProtocolMessage::setString(const MessageField field, const std::string_view value)
+{
+    strings[field] = value;
+
+    present |= 1 << field;
+}
+
+void ProtocolMessage::setInteger(const MessageField field, const uint64_t value)
+{
+    integers[field] = value;
+
+    present |= 1 << field;
+}
+
+bool ProtocolMessage::has(const MessageField field) const
+{
+    return present & (1 << field);
+}
+
+std::string_view ProtocolMessage::getString(const MessageField field) const
+{
+    return has(field) ? strings[field] : std::string_view();
+}
+
+uint64_t ProtocolMessage::getInteger(const MessageField field) const
+{
+    return has(field) ? integers[field] : 0;
+}
+
+void ProtocolMessage::encodeField(std::string& buffer, const MessageField field) const
+{
+    if (!has(field))
+    {
+        return;
+    }
+
+    buffer += ',';
+    buffer.append(FIELD_DESCRIPTORS[field].name);
+    buffer.append(":\"");
+
+    if (FIELD_DESCRIPTORS[field].encoding == FieldEncoding::EncodedInteger)
+    {
+        char digits[20];
+
+        const std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), integers[field]);
+
+        buffer.append(digits, result.ptr - digits);
+    }
+
+    else
+    {
+        buffer.append(strings[field]);
+    }
+
+    buffer += '"';
+}
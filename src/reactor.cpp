@@ -0,0 +1,404 @@
+#include "../include/reactor.h"
+
+Reactor::~Reactor()
+{
+    stop();
+
+#ifdef __linux__
+
+    if (pollHandle != -1)
+    {
+        close(pollHandle);
+    }
+
+    if (wakeHandle != -1)
+    {
+        close(wakeHandle);
+    }
+
+#endif
+}
+
+bool Reactor::start()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (running)
+    {
+        return true;
+    }
+
+#ifdef __linux__
+
+    if (pollHandle == -1)
+    {
+        pollHandle = epoll_create1(EPOLL_CLOEXEC);
+        wakeHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (pollHandle == -1 || wakeHandle == -1)
+        {
+            return false;
+        }
+
+        epoll_event event = {};
+
+        event.events = EPOLLIN;
+        event.data.fd = wakeHandle;
+
+        if (epoll_ctl(pollHandle, EPOLL_CTL_ADD, wakeHandle, &event) != 0)
+        {
+            return false;
+        }
+    }
+
+#endif
+
+    running = true;
+
+    thread = std::thread(&Reactor::run, this);
+
+    return true;
+}
+
+void Reactor::stop()
+{
+    running = false;
+
+    wake();
+
+    if (thread.joinable() && thread.get_id() != std::this_thread::get_id())
+    {
+        thread.join();
+    }
+}
+
+bool Reactor::watch(const SocketHandle handle, const unsigned int events, const std::function<void(const unsigned int)> callback)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+#ifdef __linux__
+
+    epoll_event event = {};
+
+    event.events = ((events & ReactorEvent::Readable) != 0 ? (uint32_t)EPOLLIN : 0) | ((events & ReactorEvent::Writable) != 0 ? (uint32_t)EPOLLOUT : 0);
+    event.data.fd = handle;
+
+    if (epoll_ctl(pollHandle, watches.count(handle) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, handle, &event) != 0)
+    {
+        return false;
+    }
+
+#endif
+
+    watches[handle] = { events, callback };
+
+    wake();
+
+    return true;
+}
+
+void Reactor::unwatch(const SocketHandle handle)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (watches.erase(handle) == 0)
+    {
+        return;
+    }
+
+#ifdef __linux__
+
+    epoll_ctl(pollHandle, EPOLL_CTL_DEL, handle, nullptr);
+
+#endif
+}
+
+uint64_t Reactor::addTimer(const unsigned int interval, const bool repeat, const std::function<void()> callback)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    const uint64_t timer = nextTimer++;
+
+    timers[timer] = { std::chrono::steady_clock::now() + std::chrono::milliseconds(interval), interval, repeat, callback };
+
+    wake();
+
+    return timer;
+}
+
+void Reactor::cancelTimer(const uint64_t timer)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    timers.erase(timer);
+}
+
+void Reactor::post(const std::function<void()> function)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        posted.push_back(function);
+    }
+
+    wake();
+}
+
+void Reactor::synchronize()
+{
+    if (!running || std::this_thread::get_id() == thread.get_id())
+    {
+        return;
+    }
+
+    std::mutex mutex;
+    std::condition_variable signal;
+
+    bool done = false;
+
+    // The second post runs after a fresh wait, so every event pending at the call has been handled.
+
+    post([&]()
+    {
+        post([&]()
+        {
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+
+                done = true;
+            }
+
+            signal.notify_all();
+        });
+    });
+
+    std::unique_lock<std::mutex> guard(mutex);
+
+    signal.wait(guard, [&]()
+    {
+        return done;
+    });
+}
+
+void Reactor::run()
+{
+    std::vector<std::pair<SocketHandle, unsigned int>> ready;
+
+    while (running)
+    {
+        ready.clear();
+
+        wait(getTimeout(), ready);
+
+        for (const std::pair<SocketHandle, unsigned int>& event : ready)
+        {
+            std::function<void(const unsigned int)> callback;
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+
+                const std::unordered_map<SocketHandle, ReactorWatch>::iterator watch = watches.find(event.first);
+
+                if (watch == watches.end())
+                {
+                    continue;
+                }
+
+                callback = watch->second.callback;
+            }
+
+            callback(event.second);
+        }
+
+        std::vector<std::function<void()>> functions;
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+
+            const std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+
+            for (std::map<uint64_t, ReactorTimer>::iterator timer = timers.begin(); timer != timers.end();)
+            {
+                if (timer->second.due > now)
+                {
+                    timer++;
+
+                    continue;
+                }
+
+                functions.push_back(timer->second.callback);
+
+                if (timer->second.repeat)
+                {
+                    timer->second.due = now + std::chrono::milliseconds(timer->second.interval);
+
+                    timer++;
+                }
+
+                else
+                {
+                    timer = timers.erase(timer);
+                }
+            }
+
+            functions.insert(functions.end(), posted.begin(), posted.end());
+
+            posted.clear();
+        }
+
+        for (const std::function<void()>& function : functions)
+        {
+            function();
+        }
+    }
+}
+
+void Reactor::wait(const int timeout, std::vector<std::pair<SocketHandle, unsigned int>>& ready)
+{
+#ifdef __linux__
+
+    epoll_event events[REACTOR_EVENTS];
+
+    const int count = epoll_wait(pollHandle, events, REACTOR_EVENTS, timeout);
+
+    for (int i = 0; i < count; i++)
+    {
+        const int handle = events[i].data.fd;
+
+        if (handle == wakeHandle)
+        {
+            uint64_t value = 0;
+
+            while (read(wakeHandle, &value, sizeof(value)) > 0);
+
+            continue;
+        }
+
+        unsigned int flags = 0;
+
+        if (events[i].events & EPOLLIN)
+        {
+            flags |= ReactorEvent::Readable;
+        }
+
+        if (events[i].events & EPOLLOUT)
+        {
+            flags |= ReactorEvent::Writable;
+        }
+
+        if (events[i].events & (EPOLLHUP | EPOLLERR))
+        {
+            flags |= ReactorEvent::Hangup | ReactorEvent::Readable;
+        }
+
+        ready.push_back({ handle, flags });
+    }
+
+#else
+
+    const int interval = timeout < 0 || timeout > REACTOR_INTERVAL ? REACTOR_INTERVAL : timeout;
+
+    std::vector<pollfd> handles;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        for (const std::pair<const SocketHandle, ReactorWatch>& watch : watches)
+        {
+            pollfd handle = {};
+
+            handle.fd = watch.first;
+            handle.events = ((watch.second.events & ReactorEvent::Readable) != 0 ? POLLIN : 0) | ((watch.second.events & ReactorEvent::Writable) != 0 ? POLLOUT : 0);
+
+            handles.push_back(handle);
+        }
+    }
+
+    if (handles.empty())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+
+        return;
+    }
+
+#ifdef _WIN32
+    const int count = WSAPoll(handles.data(), handles.size(), interval);
+#else
+    const int count = poll(handles.data(), handles.size(), interval);
+#endif
+
+    for (int i = 0; i < (int)handles.size() && count > 0; i++)
+    {
+        unsigned int flags = 0;
+
+        if (handles[i].revents & POLLIN)
+        {
+            flags |= ReactorEvent::Readable;
+        }
+
+        if (handles[i].revents & POLLOUT)
+        {
+            flags |= ReactorEvent::Writable;
+        }
+
+        if (handles[i].revents & (POLLHUP | POLLERR))
+        {
+            flags |= ReactorEvent::Hangup | ReactorEvent::Readable;
+        }
+
+        if (flags != 0)
+        {
+            ready.push_back({ handles[i].fd, flags });
+        }
+    }
+
+#endif
+}
+
+void Reactor::wake() const
+{
+#ifdef __linux__
+
+    if (wakeHandle != -1)
+    {
+        const uint64_t value = 1;
+
+        write(wakeHandle, &value, sizeof(value));
+    }
+
+#endif
+}
+
+int Reactor::getTimeout()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (!posted.empty())
+    {
+        return 0;
+    }
+
+    if (timers.empty())
+    {
+        return -1;
+    }
+
+    const std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+
+    std::chrono::time_point<std::chrono::steady_clock> due = timers.begin()->second.due;
+
+    for (const std::pair<const uint64_t, ReactorTimer>& timer : timers)
+    {
+        if (timer.second.due < due)
+        {
+            due = timer.second.due;
+        }
+    }
+
+    if (due <= now)
+    {
+        return 0;
+    }
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(due - now).count() + 1;
+}
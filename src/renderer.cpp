@@ -1,7 +1,7 @@
 #include "renderer.h"
 
-Target::Target(const GUIObject* object, const std::string name, const std::string ip) :
-    object(object), name(name), ip(ip) {}
+Target::Target(const GUIObject* object, Button* button, const std::string name, const std::string ip) :
+    object(object), button(button), name(name), ip(ip) {}
 
 Renderer::Renderer(MainThreadQueue* mainThreadQueue, ErrorHandler* errorHandler, NetworkManager* networkManager, FileManager* fileManager) :
     mainThreadQueue(mainThreadQueue), errorHandler(errorHandler), networkManager(networkManager), fileManager(fileManager)
@@ -43,9 +43,9 @@ Renderer::~Renderer()
     SDL_Quit();
 }
 
-void Renderer::setPath(const std::string path)
+void Renderer::setPaths(const std::vector<std::filesystem::path> paths)
 {
-    this->path = path;
+    this->paths = paths;
 }
 
 void Renderer::setupMain()
@@ -53,22 +53,25 @@ void Renderer::setupMain()
     networkManager->beginClient(std::bind(&Renderer::handleResponse, this, std::placeholders::_1, std::placeholders::_2));
 }
 
-void Renderer::setupReceive(const std::string name, const std::string& data)
+void Renderer::setupReceive(const std::string name, ReceiveResult* result)
 {
     const std::filesystem::path path = fileManager->getSavePath(name);
 
-    std::ofstream file(path, std::ios::binary);
-
-    if (!file.is_open())
+    if (path.empty())
     {
-        errorHandler->handle(SquirrelFileException("Failed to save file."));
+        result->discard();
+
+        delete result;
 
         return;
     }
 
-    file << data;
+    if (!result->commit(path))
+    {
+        errorHandler->handle(SquirrelFileException("Failed to save file."));
+    }
 
-    file.close();
+    delete result;
 }
 
 void Renderer::run()
@@ -123,6 +126,8 @@ void Renderer::render()
 {
     renderLock.lock();
 
+    updateTargets();
+
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
     SDL_RenderClear(renderer);
 
@@ -184,14 +189,14 @@ void Renderer::handleResponse(const std::string name, const std::string ip)
         sendButton->setTextColor({ 50, 50, 50, 255 });
         sendButton->setAction([=]()
         {
-            if (path.empty())
+            if (paths.empty())
             {
                 // choose file
 
                 return;
             }
 
-            networkManager->beginTransfer(path, ip);
+            networkManager->beginTransfer(paths, ip);
         });
 
         layout->addObject(sendButton, Sizing::Fixed, Sizing::Fixed);
@@ -199,12 +204,60 @@ void Renderer::handleResponse(const std::string name, const std::string ip)
         root->addObject(layout, Sizing::Stretch, Sizing::Fixed);
         root->layout();
 
-        targets.push_back(new Target(layout, name, ip));
+        targets.push_back(new Target(layout, sendButton, name, ip));
     }
 
     renderLock.unlock();
 }
 
+void Renderer::updateTargets()
+{
+    const std::vector<TransferStatus> transfers = networkManager->getTransfers();
+
+    for (Target* target : targets)
+    {
+        std::string status = "Send";
+
+        // Transfers are listed oldest first, so the latest one for a peer decides what its button shows.
+
+        for (const TransferStatus& transfer : transfers)
+        {
+            if (transfer.ip != target->ip)
+            {
+                continue;
+            }
+
+            if (transfer.state == TransferState::TransferQueued)
+            {
+                status = "Queued";
+            }
+
+            else if (transfer.state == TransferState::TransferActive)
+            {
+                status = transfer.size > 0 ? std::to_string(std::min<uint64_t>(transfer.sent * 100 / transfer.size, 99)) + "%" : "Sending";
+            }
+
+            else if (transfer.state == TransferState::TransferFailed)
+            {
+                status = "Retry";
+            }
+
+            else
+            {
+                status = "Sent";
+            }
+        }
+
+        if (status != target->status)
+        {
+            target->status = status;
+
+            target->button->setText(status);
+            target->button->layout();
+        }
+    }
+}
+
 bool eventWatch(void* userdata, SDL_Event* event)
 {
     switch (event->type)
@@ -0,0 +1,329 @@
+#include "../include/scheduler.h"
+
+static uint64_t measurePaths(const std::vector<std::filesystem::path>& paths)
+{
+    uint64_t size = 0;
+
+    std::error_code error;
+
+    for (const std::filesystem::path& path : paths)
+    {
+        if (std::filesystem::is_regular_file(path, error))
+        {
+            size += std::filesystem::file_size(path, error);
+
+            continue;
+        }
+
+        for (std::filesystem::recursive_directory_iterator entry(path, error), end; !error && entry != end; entry.increment(error))
+        {
+            if (entry->is_regular_file(error))
+            {
+                size += entry->file_size(error);
+            }
+        }
+    }
+
+    return size;
+}
+
+TransferJob::TransferJob(const uint64_t id, const std::vector<std::filesystem::path> paths, const std::string ip, const std::shared_ptr<ChunkCache> cache, const std::shared_ptr<TokenBucket> peer, TokenBucket* global) :
+    id(id), paths(paths), ip(ip), cache(cache), peer(peer), global(global) {}
+
+void TransferJob::pace(const uint64_t bytes)
+{
+    std::this_thread::sleep_until(std::max({ bucket.reserve(bytes), peer->reserve(bytes), global->reserve(bytes) }));
+}
+
+void TransferJob::setBandwidth(const uint64_t bandwidth)
+{
+    bucket.setRate(bandwidth);
+}
+
+void TransferJob::setConnections(const std::vector<SocketTuning> connections)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    this->connections = connections;
+}
+
+bool TransferJob::isShaped()
+{
+    return bucket.getRate() > 0 || peer->getRate() > 0 || global->getRate() > 0;
+}
+
+TransferStatus TransferJob::getStatus()
+{
+    TransferStatus status;
+
+    status.id = id;
+    status.ip = ip;
+    status.name = paths.empty() ? "" : paths[0].filename().string();
+    status.state = state;
+    status.sent = sent;
+    status.size = size;
+
+    status.bandwidth = bucket.getRate();
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        status.connections = connections;
+    }
+
+    if (paths.size() > 1)
+    {
+        status.name += " and " + std::to_string(paths.size() - 1) + " more";
+    }
+
+    return status;
+}
+
+TransferScheduler::TransferScheduler(const std::function<bool(TransferJob*)> run) :
+    run(run) {}
+
+TransferScheduler::~TransferScheduler()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        stopping = true;
+    }
+
+    signal.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    for (TransferJob* job : jobs)
+    {
+        delete job;
+    }
+}
+
+uint64_t TransferScheduler::enqueue(const std::vector<std::filesystem::path> paths, const std::string ip, const std::shared_ptr<ChunkCache> cache)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    const uint64_t id = nextJob++;
+
+    TransferJob* job = new TransferJob(id, paths, ip, cache, getPeer(ip), &global);
+
+    job->setBandwidth(transferBandwidth);
+
+    jobs.push_back(job);
+
+    if (workers.size() < concurrency)
+    {
+        workers.push_back(std::thread(&TransferScheduler::work, this));
+    }
+
+    signal.notify_all();
+
+    return id;
+}
+
+void TransferScheduler::setConcurrency(const unsigned int concurrency)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    this->concurrency = std::clamp(concurrency, 1u, (unsigned int)MAX_CONCURRENCY);
+
+    while (workers.size() < this->concurrency && workers.size() < jobs.size())
+    {
+        workers.push_back(std::thread(&TransferScheduler::work, this));
+    }
+
+    signal.notify_all();
+}
+
+void TransferScheduler::setBandwidth(const uint64_t bandwidth)
+{
+    global.setRate(bandwidth);
+}
+
+void TransferScheduler::setPeerBandwidth(const uint64_t bandwidth)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    peerBandwidth = bandwidth;
+
+    for (const std::pair<const std::string, std::shared_ptr<TokenBucket>>& peer : peers)
+    {
+        if (peerLimits.count(peer.first) == 0)
+        {
+            peer.second->setRate(bandwidth);
+        }
+    }
+}
+
+void TransferScheduler::setPeerBandwidth(const std::string ip, const uint64_t bandwidth)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    peerLimits[ip] = bandwidth;
+
+    if (peers.count(ip) > 0)
+    {
+        peers[ip]->setRate(bandwidth);
+    }
+}
+
+void TransferScheduler::setTransferBandwidth(const uint64_t bandwidth)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    transferBandwidth = bandwidth;
+
+    for (TransferJob* job : jobs)
+    {
+        if (!job->limited)
+        {
+            job->setBandwidth(bandwidth);
+        }
+    }
+}
+
+void TransferScheduler::setTransferBandwidth(const uint64_t id, const uint64_t bandwidth)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    for (TransferJob* job : jobs)
+    {
+        if (job->id == id)
+        {
+            job->limited = true;
+
+            job->setBandwidth(bandwidth);
+        }
+    }
+}
+
+std::vector<TransferStatus> TransferScheduler::getTransfers()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    std::vector<TransferStatus> transfers;
+
+    for (TransferJob* job : jobs)
+    {
+        transfers.push_back(job->getStatus());
+    }
+
+    return transfers;
+}
+
+void TransferScheduler::work()
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    while (true)
+    {
+        TransferJob* job = nullptr;
+
+        signal.wait(guard, [&]()
+        {
+            return stopping || (active < concurrency && (job = next()));
+        });
+
+        if (stopping)
+        {
+            return;
+        }
+
+        job->state = TransferState::TransferActive;
+
+        active++;
+
+        guard.unlock();
+
+        job->size = measurePaths(job->paths);
+
+        const bool sent = run(job);
+
+        guard.lock();
+
+        job->state = sent ? TransferState::TransferComplete : TransferState::TransferFailed;
+
+        active--;
+
+        prune();
+
+        signal.notify_all();
+    }
+}
+
+void TransferScheduler::prune()
+{
+    size_t finished = std::count_if(jobs.begin(), jobs.end(), [](const TransferJob* job)
+    {
+        return job->state == TransferState::TransferComplete || job->state == TransferState::TransferFailed;
+    });
+
+    for (std::deque<TransferJob*>::iterator job = jobs.begin(); job != jobs.end() && finished > TRANSFER_HISTORY;)
+    {
+        if ((*job)->state == TransferState::TransferComplete || (*job)->state == TransferState::TransferFailed)
+        {
+            delete *job;
+
+            job = jobs.erase(job);
+
+            finished--;
+        }
+
+        else
+        {
+            job++;
+        }
+    }
+
+    for (std::unordered_map<std::string, std::shared_ptr<TokenBucket>>::iterator peer = peers.begin(); peer != peers.end();)
+    {
+        if (peer->second.use_count() == 1)
+        {
+            peer = peers.erase(peer);
+        }
+
+        else
+        {
+            peer++;
+        }
+    }
+}
+
+TransferJob* TransferScheduler::next()
+{
+    for (TransferJob* job : jobs)
+    {
+        if (job->state != TransferState::TransferQueued)
+        {
+            continue;
+        }
+
+        const bool busy = std::any_of(jobs.begin(), jobs.end(), [&](const TransferJob* other)
+        {
+            return other->state == TransferState::TransferActive && other->ip == job->ip;
+        });
+
+        if (!busy)
+        {
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<TokenBucket> TransferScheduler::getPeer(const std::string ip)
+{
+    if (peers.count(ip) == 0)
+    {
+        peers[ip] = std::make_shared<TokenBucket>();
+
+        peers[ip]->setRate(peerLimits.count(ip) > 0 ? peerLimits[ip] : peerBandwidth);
+    }
+
+    return peers[ip];
+}
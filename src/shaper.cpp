@@ -0,0 +1,46 @@
+#include "../include/shaper.h"
+
+static std::chrono::steady_clock::duration toDuration(const double bytes, const uint64_t rate)
+{
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(bytes / rate));
+}
+
+void TokenBucket::setRate(const uint64_t rate)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    const std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+
+    const double owed = this->rate > 0 && ready > now ? std::chrono::duration<double>(ready - now).count() * this->rate : 0;
+
+    this->rate = rate;
+
+    ready = rate > 0 ? now + toDuration(owed, rate) : now;
+}
+
+uint64_t TokenBucket::getRate()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    return rate;
+}
+
+std::chrono::time_point<std::chrono::steady_clock> TokenBucket::reserve(const uint64_t bytes)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    const std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+
+    if (rate == 0)
+    {
+        return now;
+    }
+
+    ready = std::max(ready, now);
+
+    const std::chrono::time_point<std::chrono::steady_clock> due = std::max(now, ready - toDuration(SHAPER_BURST, rate));
+
+    ready += toDuration(bytes, rate);
+
+    return due;
+}
@@ -0,0 +1,452 @@
+#include "../include/store.h"
+
+static void writeInteger(char* buffer, const uint64_t value, const unsigned int size)
+{
+    for (unsigned int i = 0; i < size; i++)
+    {
+        buffer[i] = (value >> (i * 8)) & 0xff;
+    }
+}
+
+static uint64_t readInteger(const char* buffer, const unsigned int size)
+{
+    uint64_t value = 0;
+
+    for (unsigned int i = 0; i < size; i++)
+    {
+        value |= (uint64_t)(unsigned char)buffer[i] << (i * 8);
+    }
+
+    return value;
+}
+
+ContentChunker::ContentChunker()
+{
+    std::mt19937_64 generator(0x5371726c);
+
+    for (uint64_t& value : gear)
+    {
+        value = generator();
+    }
+}
+
+bool ContentChunker::split(const File& file, const uint64_t size, std::vector<StoredChunk>& chunks) const
+{
+    chunks.clear();
+
+    std::vector<char> buffer(STORE_MAX_CHUNK * 8);
+
+    uint64_t bufferStart = 0;
+    uint64_t bufferEnd = 0;
+
+    uint64_t offset = 0;
+
+    while (offset < size)
+    {
+        if (bufferEnd - offset < STORE_MAX_CHUNK && bufferEnd < size)
+        {
+            memmove(buffer.data(), buffer.data() + (offset - bufferStart), bufferEnd - offset);
+
+            bufferStart = offset;
+
+            const uint64_t space = buffer.size() - (bufferEnd - bufferStart);
+            const uint64_t count = size - bufferEnd < space ? size - bufferEnd : space;
+
+            if (!file.readAt(buffer.data() + (bufferEnd - bufferStart), count, bufferEnd))
+            {
+                return false;
+            }
+
+            bufferEnd += count;
+        }
+
+        const char* data = buffer.data() + (offset - bufferStart);
+
+        const size_t length = cut((const unsigned char*)data, bufferEnd - offset);
+
+        StoredChunk chunk;
+
+        chunk.hash = Sha256::digest(data, length);
+        chunk.offset = offset;
+        chunk.size = length;
+
+        chunks.push_back(chunk);
+
+        offset += length;
+    }
+
+    return true;
+}
+
+std::string ContentChunker::encode(const std::vector<StoredChunk>& chunks)
+{
+    std::string data(chunks.size() * STORE_OFFER_SIZE, '\0');
+
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        memcpy(data.data() + i * STORE_OFFER_SIZE, chunks[i].hash.data(), SHA256_SIZE);
+
+        writeInteger(data.data() + i * STORE_OFFER_SIZE + SHA256_SIZE, chunks[i].size, 4);
+    }
+
+    return data;
+}
+
+bool ContentChunker::decode(const std::string& data, const uint64_t size, std::vector<StoredChunk>& chunks)
+{
+    if (data.size() % STORE_OFFER_SIZE != 0)
+    {
+        return false;
+    }
+
+    chunks.resize(data.size() / STORE_OFFER_SIZE);
+
+    uint64_t offset = 0;
+
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        chunks[i].hash = data.substr(i * STORE_OFFER_SIZE, SHA256_SIZE);
+        chunks[i].offset = offset;
+        chunks[i].size = readInteger(data.data() + i * STORE_OFFER_SIZE + SHA256_SIZE, 4);
+
+        if (chunks[i].size == 0 || chunks[i].size > STORE_MAX_CHUNK || chunks[i].size > size - offset)
+        {
+            return false;
+        }
+
+        offset += chunks[i].size;
+    }
+
+    return offset == size;
+}
+
+size_t ContentChunker::cut(const unsigned char* data, const size_t size) const
+{
+    if (size <= STORE_MIN_CHUNK)
+    {
+        return size;
+    }
+
+    const size_t limit = size < STORE_MAX_CHUNK ? size : STORE_MAX_CHUNK;
+    const size_t normal = limit < STORE_AVERAGE_CHUNK ? limit : STORE_AVERAGE_CHUNK;
+
+    uint64_t fingerprint = 0;
+
+    size_t i = STORE_MIN_CHUNK;
+
+    for (; i < normal; i++)
+    {
+        fingerprint = (fingerprint << 1) + gear[data[i]];
+
+        if ((fingerprint & STORE_MASK_SMALL) == 0)
+        {
+            return i + 1;
+        }
+    }
+
+    for (; i < limit; i++)
+    {
+        fingerprint = (fingerprint << 1) + gear[data[i]];
+
+        if ((fingerprint & STORE_MASK_LARGE) == 0)
+        {
+            return i + 1;
+        }
+    }
+
+    return limit;
+}
+
+ChunkStore::ChunkStore(const std::filesystem::path directory) :
+    indexPath(directory / "chunks.index"), packPath(directory / "chunks.pack")
+{
+    std::error_code error;
+
+    std::filesystem::create_directories(directory, error);
+
+    if (error || !open())
+    {
+        index.close();
+        pack.close();
+    }
+}
+
+bool ChunkStore::isOpen() const
+{
+    return index.isOpen() && pack.isOpen();
+}
+
+bool ChunkStore::contains(const std::string& hash)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    uint64_t slot = 0;
+
+    bool found = false;
+
+    char record[STORE_SLOT_SIZE];
+
+    return find(index, capacity, hash, slot, found, record) && found;
+}
+
+bool ChunkStore::read(const std::string& hash, char* buffer, const uint32_t size)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    uint64_t slot = 0;
+
+    bool found = false;
+
+    char record[STORE_SLOT_SIZE];
+
+    if (!find(index, capacity, hash, slot, found, record) || !found)
+    {
+        return false;
+    }
+
+    const uint64_t offset = readInteger(record + SHA256_SIZE, 8);
+
+    if (readInteger(record + SHA256_SIZE + 8, 4) != size || offset + size > packSize)
+    {
+        return false;
+    }
+
+    return pack.readAt(buffer, size, offset);
+}
+
+bool ChunkStore::insert(const std::string& hash, const char* data, const uint32_t size)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if ((count + 1) * 100 > capacity * STORE_MAX_LOAD && !grow())
+    {
+        return false;
+    }
+
+    uint64_t slot = 0;
+
+    bool found = false;
+
+    char record[STORE_SLOT_SIZE];
+
+    if (!find(index, capacity, hash, slot, found, record))
+    {
+        return false;
+    }
+
+    if (found)
+    {
+        return true;
+    }
+
+    if (!pack.writeAt(data, size, packSize))
+    {
+        return false;
+    }
+
+    memcpy(record, hash.data(), SHA256_SIZE);
+
+    writeInteger(record + SHA256_SIZE, packSize, 8);
+    writeInteger(record + SHA256_SIZE + 8, size, 4);
+    writeInteger(record + SHA256_SIZE + 12, 1, 4);
+
+    if (!index.writeAt(record, STORE_SLOT_SIZE, STORE_HEADER_SIZE + slot * STORE_SLOT_SIZE))
+    {
+        return false;
+    }
+
+    packSize += size;
+    count++;
+
+    return writeHeader();
+}
+
+bool ChunkStore::flush()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    return pack.sync() && index.sync();
+}
+
+uint64_t ChunkStore::getCount() const
+{
+    return count;
+}
+
+bool ChunkStore::open()
+{
+    if (!pack.openWrite(packPath, false))
+    {
+        return false;
+    }
+
+    packSize = pack.getSize();
+
+    if (!std::filesystem::exists(indexPath))
+    {
+        if (!index.openWrite(indexPath, true) || !create(index, STORE_INITIAL_SLOTS))
+        {
+            return false;
+        }
+
+        capacity = STORE_INITIAL_SLOTS;
+        count = 0;
+
+        return true;
+    }
+
+    if (!index.openWrite(indexPath, false) || index.getSize() < STORE_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    char header[STORE_HEADER_SIZE];
+
+    if (!index.readAt(header, STORE_HEADER_SIZE, 0) || memcmp(header, STORE_INDEX_MAGIC, 4) != 0)
+    {
+        return false;
+    }
+
+    capacity = readInteger(header + 4, 8);
+    count = readInteger(header + 12, 8);
+
+    return capacity > 0 && count <= capacity && index.getSize() == STORE_HEADER_SIZE + capacity * STORE_SLOT_SIZE;
+}
+
+bool ChunkStore::create(File& file, const uint64_t slots) const
+{
+    if (!file.allocate(STORE_HEADER_SIZE + slots * STORE_SLOT_SIZE))
+    {
+        return false;
+    }
+
+    char header[STORE_HEADER_SIZE];
+
+    memcpy(header, STORE_INDEX_MAGIC, 4);
+
+    writeInteger(header + 4, slots, 8);
+    writeInteger(header + 12, 0, 8);
+
+    return file.writeAt(header, STORE_HEADER_SIZE, 0);
+}
+
+bool ChunkStore::find(const File& file, const uint64_t slots, const std::string& hash, uint64_t& slot, bool& found, char* record) const
+{
+    if (hash.size() != SHA256_SIZE)
+    {
+        return false;
+    }
+
+    slot = readInteger(hash.data(), 8) % slots;
+
+    for (uint64_t probe = 0; probe < slots; probe++)
+    {
+        if (!file.readAt(record, STORE_SLOT_SIZE, STORE_HEADER_SIZE + slot * STORE_SLOT_SIZE))
+        {
+            return false;
+        }
+
+        if (readInteger(record + SHA256_SIZE + 12, 4) == 0)
+        {
+            found = false;
+
+            return true;
+        }
+
+        if (memcmp(record, hash.data(), SHA256_SIZE) == 0)
+        {
+            found = true;
+
+            return true;
+        }
+
+        slot = (slot + 1) % slots;
+    }
+
+    return false;
+}
+
+bool ChunkStore::grow()
+{
+    const std::filesystem::path tempPath = indexPath.string() + ".tmp";
+
+    const uint64_t slots = capacity * 2;
+
+    File table;
+
+    if (!table.openWrite(tempPath, true) || !create(table, slots))
+    {
+        return false;
+    }
+
+    std::vector<char> buffer(STORE_SLOT_SIZE * 1024);
+
+    for (uint64_t first = 0; first < capacity; first += 1024)
+    {
+        const uint64_t batch = capacity - first < 1024 ? capacity - first : 1024;
+
+        if (!index.readAt(buffer.data(), batch * STORE_SLOT_SIZE, STORE_HEADER_SIZE + first * STORE_SLOT_SIZE))
+        {
+            return false;
+        }
+
+        for (uint64_t i = 0; i < batch; i++)
+        {
+            const char* record = buffer.data() + i * STORE_SLOT_SIZE;
+
+            if (readInteger(record + SHA256_SIZE + 12, 4) == 0)
+            {
+                continue;
+            }
+
+            uint64_t slot = 0;
+
+            bool found = false;
+
+            char existing[STORE_SLOT_SIZE];
+
+            if (!find(table, slots, std::string(record, SHA256_SIZE), slot, found, existing))
+            {
+                return false;
+            }
+
+            if (!table.writeAt(record, STORE_SLOT_SIZE, STORE_HEADER_SIZE + slot * STORE_SLOT_SIZE))
+            {
+                return false;
+            }
+        }
+    }
+
+    char header[8];
+
+    writeInteger(header, count, 8);
+
+    if (!table.writeAt(header, 8, 12) || !table.sync() || !table.close())
+    {
+        return false;
+    }
+
+    index.close();
+
+    std::error_code error;
+
+    std::filesystem::rename(tempPath, indexPath, error);
+
+    if (error || !index.openWrite(indexPath, false))
+    {
+        return false;
+    }
+
+    capacity = slots;
+
+    return true;
+}
+
+bool ChunkStore::writeHeader()
+{
+    char header[8];
+
+    writeInteger(header, count, 8);
+
+    return index.writeAt(header, 8, 12);
+}
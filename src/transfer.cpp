@@ -0,0 +1,899 @@
+#include "../include/transfer.h"
+
+#ifdef _WIN32
+
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <Windows.h>
+
+#else
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#endif
+
+File::~File()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool File::openRead(const std::filesystem::path path)
+{
+    descriptor = _wopen(path.c_str(), _O_RDONLY | _O_BINARY);
+
+    return descriptor != -1;
+}
+
+bool File::openWrite(const std::filesystem::path path, const bool truncate)
+{
+    descriptor = _wopen(path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY | (truncate ? _O_TRUNC : 0), _S_IREAD | _S_IWRITE);
+
+    return descriptor != -1;
+}
+
+bool File::readAt(char* buffer, const uint64_t size, const uint64_t offset) const
+{
+    const HANDLE handle = (HANDLE)_get_osfhandle(descriptor);
+
+    uint64_t done = 0;
+
+    while (done < size)
+    {
+        OVERLAPPED overlapped;
+
+        memset(&overlapped, 0, sizeof(overlapped));
+
+        overlapped.Offset = (offset + done) & 0xffffffff;
+        overlapped.OffsetHigh = (offset + done) >> 32;
+
+        const DWORD request = size - done < MAXDWORD ? (DWORD)(size - done) : MAXDWORD;
+
+        DWORD result = 0;
+
+        if (!ReadFile(handle, buffer + done, request, &result, &overlapped) || result == 0)
+        {
+            return false;
+        }
+
+        done += result;
+    }
+
+    return true;
+}
+
+bool File::writeAt(const char* data, const uint64_t size, const uint64_t offset) const
+{
+    const HANDLE handle = (HANDLE)_get_osfhandle(descriptor);
+
+    uint64_t done = 0;
+
+    while (done < size)
+    {
+        OVERLAPPED overlapped;
+
+        memset(&overlapped, 0, sizeof(overlapped));
+
+        overlapped.Offset = (offset + done) & 0xffffffff;
+        overlapped.OffsetHigh = (offset + done) >> 32;
+
+        const DWORD request = size - done < MAXDWORD ? (DWORD)(size - done) : MAXDWORD;
+
+        DWORD result = 0;
+
+        if (!WriteFile(handle, data + done, request, &result, &overlapped) || result == 0)
+        {
+            return false;
+        }
+
+        done += result;
+    }
+
+    return true;
+}
+
+bool File::allocate(const uint64_t size) const
+{
+    return _chsize_s(descriptor, size) == 0;
+}
+
+bool File::sync() const
+{
+    return _commit(descriptor) == 0;
+}
+
+bool File::close()
+{
+    if (descriptor == -1)
+    {
+        return true;
+    }
+
+    const bool result = _close(descriptor) == 0;
+
+    descriptor = -1;
+
+    return result;
+}
+
+uint64_t File::getSize() const
+{
+    return _filelengthi64(descriptor);
+}
+
+#else
+
+bool File::openRead(const std::filesystem::path path)
+{
+    descriptor = open(path.c_str(), O_RDONLY);
+
+    return descriptor != -1;
+}
+
+bool File::openWrite(const std::filesystem::path path, const bool truncate)
+{
+    descriptor = open(path.c_str(), O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0), 0644);
+
+    return descriptor != -1;
+}
+
+bool File::readAt(char* buffer, const uint64_t size, const uint64_t offset) const
+{
+    uint64_t done = 0;
+
+    while (done < size)
+    {
+        const ssize_t result = pread(descriptor, buffer + done, size - done, offset + done);
+
+        if (result <= 0)
+        {
+            return false;
+        }
+
+        done += result;
+    }
+
+    return true;
+}
+
+bool File::writeAt(const char* data, const uint64_t size, const uint64_t offset) const
+{
+    uint64_t done = 0;
+
+    while (done < size)
+    {
+        const ssize_t result = pwrite(descriptor, data + done, size - done, offset + done);
+
+        if (result <= 0)
+        {
+            return false;
+        }
+
+        done += result;
+    }
+
+    return true;
+}
+
+bool File::allocate(const uint64_t size) const
+{
+#ifdef __linux__
+
+    if (posix_fallocate(descriptor, 0, size) == 0)
+    {
+        return true;
+    }
+
+#endif
+
+    return ftruncate(descriptor, size) == 0;
+}
+
+bool File::sync() const
+{
+#ifdef __linux__
+
+    return fdatasync(descriptor) == 0;
+
+#else
+
+    return fsync(descriptor) == 0;
+
+#endif
+}
+
+bool File::close()
+{
+    if (descriptor == -1)
+    {
+        return true;
+    }
+
+    const bool result = ::close(descriptor) == 0;
+
+    descriptor = -1;
+
+    return result;
+}
+
+uint64_t File::getSize() const
+{
+    struct stat info;
+
+    if (fstat(descriptor, &info) != 0)
+    {
+        return 0;
+    }
+
+    return info.st_size;
+}
+
+#endif
+
+bool File::isOpen() const
+{
+    return descriptor != -1;
+}
+
+int File::getDescriptor() const
+{
+    return descriptor;
+}
+
+ChunkReader::ChunkReader(const std::filesystem::path path) :
+    path(path)
+{
+    if (file.openRead(path))
+    {
+        size = file.getSize();
+    }
+}
+
+bool ChunkReader::isOpen() const
+{
+    return file.isOpen();
+}
+
+bool ChunkReader::isComplete() const
+{
+    return offset == size;
+}
+
+uint64_t ChunkReader::getSize() const
+{
+    return size;
+}
+
+std::filesystem::path ChunkReader::getPath() const
+{
+    return path;
+}
+
+const File& ChunkReader::getFile() const
+{
+    return file;
+}
+
+void ChunkReader::skip(const std::vector<bool>& completed)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    skipped = completed;
+}
+
+bool ChunkReader::next(Chunk& chunk)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    while (offset < size && offset / CHUNK_SIZE < skipped.size() && skipped[offset / CHUNK_SIZE])
+    {
+        offset += size - offset < CHUNK_SIZE ? size - offset : CHUNK_SIZE;
+    }
+
+    if (!file.isOpen() || offset >= size)
+    {
+        return false;
+    }
+
+    const size_t length = size - offset < CHUNK_SIZE ? size - offset : CHUNK_SIZE;
+
+    chunk.offset = offset;
+    chunk.size = length;
+
+    offset += length;
+
+    return true;
+}
+
+ChunkMap::ChunkMap(const uint64_t size) :
+    size(size), chunks((size + CHUNK_SIZE - 1) / CHUNK_SIZE), remaining(chunks.size()) {}
+
+ChunkMap::ChunkMap(const uint64_t size, const std::vector<bool>& completed) :
+    size(size), chunks(completed), remaining(0)
+{
+    chunks.resize((size + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+    for (const bool chunk : chunks)
+    {
+        if (!chunk)
+        {
+            remaining++;
+        }
+    }
+}
+
+std::string ChunkMap::encode(const std::vector<bool>& chunks)
+{
+    std::string bitmap((chunks.size() + 7) / 8, '\0');
+
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        if (chunks[i])
+        {
+            bitmap[i / 8] |= 1 << (i % 8);
+        }
+    }
+
+    return bitmap;
+}
+
+bool ChunkMap::decode(const std::string& bitmap, std::vector<bool>& chunks)
+{
+    if (bitmap.size() != (chunks.size() + 7) / 8)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        chunks[i] = bitmap[i / 8] & (1 << (i % 8));
+    }
+
+    return true;
+}
+
+bool ChunkMap::mark(const uint64_t offset, const uint64_t size)
+{
+    if (offset % CHUNK_SIZE != 0 || offset >= this->size)
+    {
+        return false;
+    }
+
+    const uint64_t expected = this->size - offset < CHUNK_SIZE ? this->size - offset : CHUNK_SIZE;
+
+    if (size != expected)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (chunks[offset / CHUNK_SIZE])
+    {
+        return false;
+    }
+
+    chunks[offset / CHUNK_SIZE] = true;
+
+    remaining--;
+
+    return true;
+}
+
+bool ChunkMap::isComplete() const
+{
+    return remaining == 0;
+}
+
+ChunkHasher::ChunkHasher(const File& file, const uint64_t size) :
+    file(file), size(size), hashes((size + CHUNK_SIZE - 1) / CHUNK_SIZE), hashed(hashes.size())
+{
+    thread = std::thread(&ChunkHasher::run, this);
+}
+
+ChunkHasher::~ChunkHasher()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        pending = {};
+
+        closed = true;
+    }
+
+    signal.notify_all();
+
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+void ChunkHasher::push(const uint64_t offset)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        pending.push(offset);
+    }
+
+    signal.notify_one();
+}
+
+void ChunkHasher::record(const uint64_t offset, const uint64_t hash)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (offset % CHUNK_SIZE == 0 && offset < size)
+    {
+        hashes[offset / CHUNK_SIZE] = hash;
+        hashed[offset / CHUNK_SIZE] = true;
+    }
+}
+
+void ChunkHasher::pushAll()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        for (uint64_t offset = 0; offset < size; offset += CHUNK_SIZE)
+        {
+            pending.push(offset);
+        }
+    }
+
+    signal.notify_one();
+}
+
+bool ChunkHasher::finish(std::vector<uint64_t>& hashes)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        closed = true;
+    }
+
+    signal.notify_all();
+
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+
+    if (failed || std::find(hashed.begin(), hashed.end(), false) != hashed.end())
+    {
+        return false;
+    }
+
+    hashes = this->hashes;
+
+    return true;
+}
+
+std::string ChunkHasher::encode(const std::vector<uint64_t>& hashes)
+{
+    std::string data(hashes.size() * 8, '\0');
+
+    for (size_t i = 0; i < hashes.size(); i++)
+    {
+        for (unsigned int j = 0; j < 8; j++)
+        {
+            data[i * 8 + j] = (hashes[i] >> (j * 8)) & 0xff;
+        }
+    }
+
+    return data;
+}
+
+bool ChunkHasher::decode(const std::string& data, std::vector<uint64_t>& hashes)
+{
+    if (data.size() != hashes.size() * 8)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < hashes.size(); i++)
+    {
+        hashes[i] = 0;
+
+        for (unsigned int j = 0; j < 8; j++)
+        {
+            hashes[i] |= (uint64_t)(unsigned char)data[i * 8 + j] << (j * 8);
+        }
+    }
+
+    return true;
+}
+
+void ChunkHasher::run()
+{
+    std::vector<char> buffer(CHUNK_SIZE);
+
+    while (true)
+    {
+        uint64_t offset = 0;
+
+        {
+            std::unique_lock<std::mutex> guard(lock);
+
+            signal.wait(guard, [&]()
+            {
+                return closed || !pending.empty();
+            });
+
+            if (pending.empty() || failed)
+            {
+                return;
+            }
+
+            offset = pending.front();
+
+            pending.pop();
+        }
+
+        const uint64_t length = size - offset < CHUNK_SIZE ? size - offset : CHUNK_SIZE;
+
+        if (offset % CHUNK_SIZE != 0 || offset >= size || !file.readAt(buffer.data(), length, offset))
+        {
+            failed = true;
+
+            return;
+        }
+
+        record(offset, XXHash64::digest(buffer.data(), length, 0));
+    }
+}
+
+unsigned int StreamTuner::choose() const
+{
+    unsigned int best = 0;
+
+    for (unsigned int i = 1; i <= MAX_STREAMS; i++)
+    {
+        if (throughputs[i] > 0 && (best == 0 || throughputs[i] > throughputs[best]))
+        {
+            best = i;
+        }
+    }
+
+    if (best == 0)
+    {
+        return 1;
+    }
+
+    if (best * 2 <= MAX_STREAMS && throughputs[best * 2] == 0)
+    {
+        return best * 2;
+    }
+
+    return best;
+}
+
+void StreamTuner::record(const unsigned int streams, const double throughput)
+{
+    if (streams == 0 || streams > MAX_STREAMS)
+    {
+        return;
+    }
+
+    if (throughputs[streams] > 0)
+    {
+        throughputs[streams] = (throughputs[streams] + throughput) / 2;
+    }
+
+    else
+    {
+        throughputs[streams] = throughput;
+    }
+}
+
+ReceiveSink::ReceiveSink(const std::filesystem::path directory, const std::string name, const uint64_t key, const uint64_t size) :
+    name(name), key(key), size(size),
+    tempPath(directory / (".squirrel-" + std::to_string(key) + ".part")),
+    journalPath(directory / (".squirrel-" + std::to_string(key) + ".journal")),
+    completed((size + CHUNK_SIZE - 1) / CHUNK_SIZE)
+{
+    remaining = completed.size();
+
+    if (!resume() && !create())
+    {
+        discard();
+    }
+}
+
+bool ReceiveSink::isOpen() const
+{
+    return file.isOpen() && journal.isOpen();
+}
+
+bool ReceiveSink::isComplete() const
+{
+    return remaining == 0;
+}
+
+std::string ReceiveSink::getName() const
+{
+    return name;
+}
+
+uint64_t ReceiveSink::getKey() const
+{
+    return key;
+}
+
+uint64_t ReceiveSink::getSize() const
+{
+    return size;
+}
+
+const File& ReceiveSink::getFile() const
+{
+    return file;
+}
+
+std::vector<bool> ReceiveSink::getCompleted()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    return completed;
+}
+
+bool ReceiveSink::checkpoint(const uint64_t offset)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    pending.push_back(offset / CHUNK_SIZE);
+
+    if (pending.size() < JOURNAL_INTERVAL)
+    {
+        return true;
+    }
+
+    return flushPending();
+}
+
+bool ReceiveSink::flush()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    return flushPending();
+}
+
+bool ReceiveSink::commit(const std::filesystem::path path)
+{
+    if (!isOpen() || !flush())
+    {
+        return false;
+    }
+
+    if (!file.close())
+    {
+        discard();
+
+        return false;
+    }
+
+    std::error_code error;
+
+    std::filesystem::rename(tempPath, path, error);
+
+    if (error)
+    {
+        error.clear();
+
+        std::filesystem::copy_file(tempPath, path, std::filesystem::copy_options::overwrite_existing, error);
+
+        if (error)
+        {
+            return false;
+        }
+
+        std::filesystem::remove(tempPath, error);
+    }
+
+    journal.close();
+
+    std::filesystem::remove(journalPath, error);
+
+    return true;
+}
+
+void ReceiveSink::discard()
+{
+    file.close();
+    journal.close();
+
+    std::error_code error;
+
+    std::filesystem::remove(tempPath, error);
+    std::filesystem::remove(journalPath, error);
+}
+
+bool ReceiveSink::resume()
+{
+    if (!std::filesystem::exists(tempPath) || !std::filesystem::exists(journalPath))
+    {
+        return false;
+    }
+
+    if (!file.openWrite(tempPath, false) || !journal.openWrite(journalPath, false))
+    {
+        return false;
+    }
+
+    if (file.getSize() != size || journal.getSize() < JOURNAL_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    char header[JOURNAL_HEADER_SIZE];
+
+    if (!journal.readAt(header, JOURNAL_HEADER_SIZE, 0) || memcmp(header, JOURNAL_MAGIC, 4) != 0)
+    {
+        return false;
+    }
+
+    uint64_t journalFileSize = 0;
+
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        journalFileSize |= (uint64_t)(unsigned char)header[4 + i] << (i * 8);
+    }
+
+    if (journalFileSize != size)
+    {
+        return false;
+    }
+
+    const uint64_t records = (journal.getSize() - JOURNAL_HEADER_SIZE) / 8;
+
+    std::vector<char> buffer(records * 8);
+
+    if (!journal.readAt(buffer.data(), buffer.size(), JOURNAL_HEADER_SIZE))
+    {
+        return false;
+    }
+
+    for (uint64_t i = 0; i < records; i++)
+    {
+        uint64_t index = 0;
+
+        for (unsigned int j = 0; j < 8; j++)
+        {
+            index |= (uint64_t)(unsigned char)buffer[i * 8 + j] << (j * 8);
+        }
+
+        if (index < completed.size() && !completed[index])
+        {
+            completed[index] = true;
+
+            remaining--;
+        }
+    }
+
+    journalSize = JOURNAL_HEADER_SIZE + records * 8;
+
+    return true;
+}
+
+bool ReceiveSink::create()
+{
+    file.close();
+    journal.close();
+
+    if (!file.openWrite(tempPath, true) || !file.allocate(size))
+    {
+        return false;
+    }
+
+    if (!journal.openWrite(journalPath, true))
+    {
+        return false;
+    }
+
+    char header[JOURNAL_HEADER_SIZE];
+
+    memcpy(header, JOURNAL_MAGIC, 4);
+
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        header[4 + i] = (size >> (i * 8)) & 0xff;
+    }
+
+    if (!journal.writeAt(header, JOURNAL_HEADER_SIZE, 0))
+    {
+        return false;
+    }
+
+    journalSize = JOURNAL_HEADER_SIZE;
+
+    return true;
+}
+
+bool ReceiveSink::flushPending()
+{
+    if (pending.empty())
+    {
+        return true;
+    }
+
+    if (!file.sync())
+    {
+        return false;
+    }
+
+    std::string records(pending.size() * 8, '\0');
+
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        for (unsigned int j = 0; j < 8; j++)
+        {
+            records[i * 8 + j] = (pending[i] >> (j * 8)) & 0xff;
+        }
+    }
+
+    if (!journal.writeAt(records.data(), records.size(), journalSize))
+    {
+        return false;
+    }
+
+    journalSize += records.size();
+
+    for (const uint64_t index : pending)
+    {
+        if (!completed[index])
+        {
+            completed[index] = true;
+
+            remaining--;
+        }
+    }
+
+    pending.clear();
+
+    return true;
+}
+
+StagedResult::StagedResult(const std::filesystem::path path) :
+    path(path) {}
+
+std::string StagedResult::getName() const
+{
+    return path.filename().string();
+}
+
+bool StagedResult::commit(const std::filesystem::path path)
+{
+    std::error_code error;
+
+    std::filesystem::rename(this->path, path, error);
+
+    if (error)
+    {
+        error.clear();
+
+        std::filesystem::copy(this->path, path, std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing, error);
+    }
+
+    if (error)
+    {
+        return false;
+    }
+
+    std::filesystem::remove_all(this->path, error);
+    std::filesystem::remove(this->path.parent_path(), error);
+
+    return true;
+}
+
+void StagedResult::discard()
+{
+    std::error_code error;
+
+    std::filesystem::remove_all(path, error);
+    std::filesystem::remove(path.parent_path(), error);
+}
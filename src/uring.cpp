@@ -0,0 +1,270 @@
+#include "../include/uring.h"
+
+#ifdef __linux__
+
+IoRing::~IoRing()
+{
+    for (char* buffer : buffers)
+    {
+        munmap(buffer, bufferSize);
+    }
+
+    if (entryMemory != MAP_FAILED)
+    {
+        munmap(entryMemory, entryMemorySize);
+    }
+
+    if (ringMemory != MAP_FAILED)
+    {
+        munmap(ringMemory, ringMemorySize);
+    }
+
+    if (descriptor != -1)
+    {
+        close(descriptor);
+    }
+}
+
+bool IoRing::isSupported()
+{
+    static const bool supported = []()
+    {
+        IoRing ring;
+
+        if (!ring.create(2))
+        {
+            return false;
+        }
+
+        std::vector<char> buffer(sizeof(io_uring_probe) + IORING_OP_LAST * sizeof(io_uring_probe_op), 0);
+
+        io_uring_probe* probe = (io_uring_probe*)buffer.data();
+
+        if (syscall(__NR_io_uring_register, ring.descriptor, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) != 0)
+        {
+            return false;
+        }
+
+        for (const uint8_t opcode : { IORING_OP_SEND, IORING_OP_RECV, IORING_OP_SENDMSG, IORING_OP_RECVMSG, IORING_OP_READ_FIXED })
+        {
+            if (opcode > probe->last_op || !(probe->ops[opcode].flags & IO_URING_OP_SUPPORTED))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }();
+
+    return supported;
+}
+
+IoRing* IoRing::getLocal()
+{
+    // A ring is not safe to share between threads.
+
+    thread_local std::unique_ptr<IoRing> ring;
+    thread_local bool attempted = false;
+
+    if (!attempted)
+    {
+        attempted = true;
+
+        ring = std::make_unique<IoRing>();
+
+        if (!ring->create(URING_ENTRIES) || !ring->registerBuffers(URING_BUFFERS, URING_BUFFER_SIZE))
+        {
+            ring = nullptr;
+        }
+    }
+
+    return ring.get();
+}
+
+bool IoRing::create(const unsigned int entries)
+{
+    io_uring_params params;
+
+    memset(&params, 0, sizeof(params));
+
+    descriptor = syscall(__NR_io_uring_setup, entries, &params);
+
+    if (descriptor == -1 || !(params.features & IORING_FEAT_SINGLE_MMAP))
+    {
+        return false;
+    }
+
+    const uint64_t submissionSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    const uint64_t completionSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    ringMemorySize = submissionSize > completionSize ? submissionSize : completionSize;
+    ringMemory = mmap(nullptr, ringMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_SQ_RING);
+
+    entryMemorySize = params.sq_entries * sizeof(io_uring_sqe);
+    entryMemory = mmap(nullptr, entryMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_SQES);
+
+    if (ringMemory == MAP_FAILED || entryMemory == MAP_FAILED)
+    {
+        return false;
+    }
+
+    char* base = (char*)ringMemory;
+
+    submissionHead = (unsigned int*)(base + params.sq_off.head);
+    submissionTail = (unsigned int*)(base + params.sq_off.tail);
+    submissionArray = (unsigned int*)(base + params.sq_off.array);
+    submissionMask = *(unsigned int*)(base + params.sq_off.ring_mask);
+
+    completionHead = (unsigned int*)(base + params.cq_off.head);
+    completionTail = (unsigned int*)(base + params.cq_off.tail);
+    completionMask = *(unsigned int*)(base + params.cq_off.ring_mask);
+
+    submissions = (io_uring_sqe*)entryMemory;
+    completions = (io_uring_cqe*)(base + params.cq_off.cqes);
+
+    capacity = params.sq_entries;
+
+    return true;
+}
+
+bool IoRing::registerBuffers(const unsigned int count, const uint64_t size)
+{
+    std::vector<iovec> vectors;
+
+    bufferSize = size;
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        void* buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (buffer == MAP_FAILED)
+        {
+            return false;
+        }
+
+        buffers.push_back((char*)buffer);
+        vectors.push_back({ buffer, size });
+    }
+
+    return syscall(__NR_io_uring_register, descriptor, IORING_REGISTER_BUFFERS, vectors.data(), count) == 0;
+}
+
+char* IoRing::getBuffer(const unsigned int index) const
+{
+    return buffers[index];
+}
+
+io_uring_sqe* IoRing::prepare(const uint8_t opcode, const int handle, const void* address, const uint32_t length, const uint64_t offset, const uint64_t tag)
+{
+    const unsigned int tail = *submissionTail;
+
+    if (tail - __atomic_load_n(submissionHead, __ATOMIC_ACQUIRE) >= capacity)
+    {
+        return nullptr;
+    }
+
+    const unsigned int index = tail & submissionMask;
+
+    io_uring_sqe* entry = &submissions[index];
+
+    memset(entry, 0, sizeof(io_uring_sqe));
+
+    entry->opcode = opcode;
+    entry->fd = handle;
+    entry->addr = (uint64_t)address;
+    entry->len = length;
+    entry->off = offset;
+    entry->user_data = tag;
+
+    submissionArray[index] = index;
+
+    __atomic_store_n(submissionTail, tail + 1, __ATOMIC_RELEASE);
+
+    pending++;
+
+    return entry;
+}
+
+bool IoRing::wait(const unsigned int count, int* results)
+{
+    unsigned int remaining = count;
+
+    while (remaining > 0)
+    {
+        uint64_t tag = 0;
+
+        int result = 0;
+
+        if (complete(tag, result))
+        {
+            if (tag < count)
+            {
+                results[tag] = result;
+            }
+
+            remaining--;
+
+            continue;
+        }
+
+        if (!submit(remaining))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int IoRing::execute()
+{
+    int result = -EIO;
+
+    if (!wait(1, &result))
+    {
+        return -EIO;
+    }
+
+    return result;
+}
+
+bool IoRing::submit(const unsigned int minimum)
+{
+    while (true)
+    {
+        const int result = syscall(__NR_io_uring_enter, descriptor, pending, minimum, minimum > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+
+        if (result >= 0)
+        {
+            pending -= result;
+
+            return true;
+        }
+
+        if (errno != EINTR)
+        {
+            return false;
+        }
+    }
+}
+
+bool IoRing::complete(uint64_t& tag, int& result)
+{
+    const unsigned int head = *completionHead;
+
+    if (head == __atomic_load_n(completionTail, __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+
+    const io_uring_cqe& entry = completions[head & completionMask];
+
+    tag = entry.user_data;
+    result = entry.res;
+
+    __atomic_store_n(completionHead, head + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+#endif